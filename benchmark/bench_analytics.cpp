@@ -0,0 +1,148 @@
+// Columnar analytics log: write throughput, size per column and query time on
+// a log of 100M rows (pass another row count as the first argument). Query
+// results are checked against answers computed while the games were played.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <vector>
+
+#include <common/analyticslog.hpp>
+#include <common/snakegl.hpp>
+
+constexpr int QUERY_TICK = 500;
+constexpr int WALL_DISTANCE = 1;
+
+// Head for the food, never into the body or off the board
+static INPUT_TYPE chooseAction(const SnakeGL& game)
+{
+    static constexpr int dx[4] = { 0, 0, -1, 1 };
+    static constexpr int dy[4] = { -1, 1, 0, 0 };
+
+    int headX = game.getHead().x, headY = game.getHead().y;
+    INPUT_TYPE preferred[4] = {
+        game.getFood().x > headX ? RIGHT : LEFT,
+        game.getFood().y > headY ? DOWN : UP,
+        game.getDir(),
+        (INPUT_TYPE)(game.getDir() ^ 2)
+    };
+    for (INPUT_TYPE action : preferred) {
+        if ((action ^ 1) == game.getDir()) continue;
+        int x = headX + dx[action], y = headY + dy[action];
+        if (x < 0 || y < 0 || x >= game.getWidth() || y >= game.getHeight()) continue;
+        if (!game.isSnake(x, y)) return action;
+    }
+    return game.getDir();
+}
+
+static bool nearWall(int x, int y, int width, int height)
+{
+    return x <= WALL_DISTANCE || y <= WALL_DISTANCE || x >= width - 1 - WALL_DISTANCE || y >= height - 1 - WALL_DISTANCE;
+}
+
+template <typename F>
+static double milliseconds(F fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+    const uint64_t targetRows = argc > 1 ? strtoull(argv[1], nullptr, 10) : 100000000ull;
+    const char* path = "bench_analytics.snkl";
+    const GameConfig config{ 64, 64, true, 1 };
+
+    // Play until the target is reached, always finishing the last game
+    uint64_t expectedMatches = 0, expectedDeaths = 0;
+    double expectedSum = 0;
+    uint64_t games = 0;
+    double writeMs = milliseconds([&]() {
+        AnalyticsLogWriter writer(path, config.width, config.height);
+        SnakeGL game(config, SnakeRng(3));
+        int64_t tick = 0;
+        while (writer.getRows() < targetRows || !game.isGameOver()) {
+            if (game.isGameOver()) {
+                game = SnakeGL(config, game.getRng());
+                tick = 0;
+            }
+            auto decideStart = std::chrono::steady_clock::now();
+            INPUT_TYPE action = chooseAction(game);
+            auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - decideStart).count();
+            game.step(action);
+
+            AnalyticsRow row;
+            row[COLUMN_TICK] = tick;
+            row[COLUMN_HEAD_X] = game.getHead().x;
+            row[COLUMN_HEAD_Y] = game.getHead().y;
+            row[COLUMN_LENGTH] = game.getLength();
+            row[COLUMN_FOOD_X] = game.getFood().x;
+            row[COLUMN_FOOD_Y] = game.getFood().y;
+            row[COLUMN_SCORE] = game.getScore();
+            row[COLUMN_LATENCY] = latency;
+            writer.append(row);
+
+            if (tick == QUERY_TICK) {
+                expectedSum += game.getLength();
+                expectedMatches++;
+            }
+            if (game.isGameOver()) {
+                games++;
+                if (nearWall(game.getHead().x, game.getHead().y, config.width, config.height)) expectedDeaths++;
+            }
+            tick++;
+        }
+        writer.close();
+    });
+
+    AnalyticsLog log;
+    if (!log.open(path)) {
+        printf("could not open %s\n", path);
+        return 1;
+    }
+
+    const double rows = (double)log.getRows();
+    printf("%llu rows, %llu games, %zu blocks of %u rows\n", (unsigned long long)log.getRows(), (unsigned long long)games,
+        log.getBlockCount(), log.getBlockRows());
+    printf("  write (incl. playing)    %10.0f ms, %.3g rows/s\n", writeMs, rows / (writeMs / 1000));
+    printf("  file                     %10.1f MB, %.2f bytes/row (raw rows: %zu bytes)\n", log.getFileBytes() / (1024.0 * 1024.0),
+        log.getFileBytes() / rows, sizeof(AnalyticsRow));
+    for (int c = 0; c < COLUMN_COUNT; c++) {
+        printf("    %-8s %8.3f bits/row\n", columnName((LOG_COLUMN)c), 8.0 * log.getColumnBytes((LOG_COLUMN)c) / rows);
+    }
+
+    // avg(length) where tick = 500: touches the tick column and the length blocks with a match
+    ColumnAverage average{};
+    double averageMs = milliseconds([&]() { average = averageWhere(log, COLUMN_LENGTH, COLUMN_TICK, QUERY_TICK); });
+
+    // The same answer from decoding every column of every block, like a row store would
+    double fullScanMs = milliseconds([&]() {
+        std::vector<int64_t> values[COLUMN_COUNT];
+        for (auto& column : values) column.resize(log.getBlockRows());
+        double sum = 0;
+        for (size_t b = 0; b < log.getBlockCount(); b++) {
+            uint32_t blockRows = 0;
+            for (int c = 0; c < COLUMN_COUNT; c++) blockRows = log.readBlock(b, (LOG_COLUMN)c, values[c].data());
+            for (uint32_t i = 0; i < blockRows; i++) {
+                if (values[COLUMN_TICK][i] == QUERY_TICK) sum += (double)values[COLUMN_LENGTH][i];
+            }
+        }
+        if (sum < 0) printf("%f\n", sum);
+    });
+
+    uint64_t deaths = 0;
+    double deathsMs = milliseconds([&]() { deaths = deathsNearWalls(log, WALL_DISTANCE, [](uint64_t, const AnalyticsRow&) {}); });
+
+    bool averageOk = average.rows == expectedMatches && (expectedMatches == 0 || average.average == expectedSum / expectedMatches);
+    bool deathsOk = deaths == expectedDeaths;
+    printf("  avg(length) at tick %d   %10.1f ms  %.3f over %llu rows  %s\n", QUERY_TICK, averageMs, average.average,
+        (unsigned long long)average.rows, averageOk ? "ok" : "WRONG");
+    printf("  same, decoding all       %10.1f ms\n", fullScanMs);
+    printf("  deaths near walls        %10.1f ms  %llu of %llu games  %s\n", deathsMs, (unsigned long long)deaths,
+        (unsigned long long)games, deathsOk ? "ok" : "WRONG");
+
+    remove(path);
+    return averageOk && deathsOk ? 0 : 1;
+}
@@ -0,0 +1,131 @@
+// D* Lite autopilot against a naive A* that plans from scratch every tick:
+// per-decision latency on wrapping boards up to 1024x1024. Every decision's
+// path length is checked against the A* distance. The snake grows by a
+// quarter of the board width per food so there is a body to plan around.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>
+#include <queue>
+#include <vector>
+
+#include <common/dstarlite.hpp>
+#include <common/snakegl.hpp>
+
+constexpr int TICKS = 4000;
+
+// Shortest path from the head to the food through free cells, -1 if there is
+// none. Fresh search every call; the first move may not reverse the snake.
+class NaiveAStar
+{
+private:
+    struct Node
+    {
+        int f, g;
+        uint32_t cell;
+        // Lowest f first, deeper nodes first on ties
+        bool operator<(const Node& other) const { return f > other.f || (f == other.f && g < other.g); }
+    };
+
+    int width, height;
+    std::vector<int> g;
+
+    int heuristic(int x, int y, int foodX, int foodY) const
+    {
+        int dx = std::abs(x - foodX), dy = std::abs(y - foodY);
+        return std::min(dx, width - dx) + std::min(dy, height - dy);
+    }
+
+public:
+    uint64_t expanded = 0;
+
+    NaiveAStar(int _width, int _height) : width(_width), height(_height) {}
+
+    int distance(const SnakeGL& game)
+    {
+        const int foodX = game.getFood().x, foodY = game.getFood().y;
+        const uint32_t start = (uint32_t)game.getHead().y * width + game.getHead().x;
+        const uint32_t goal = (uint32_t)foodY * width + foodX;
+        g.assign((size_t)width * height, 1 << 29);
+        std::priority_queue<Node> open;
+        g[start] = 0;
+        open.push(Node{ heuristic(game.getHead().x, game.getHead().y, foodX, foodY), 0, start });
+
+        while (!open.empty()) {
+            Node node = open.top();
+            open.pop();
+            if (node.g != g[node.cell]) continue;
+            if (node.cell == goal) return node.g;
+            expanded++;
+            for (int d = 0; d < 4; d++) {
+                if (node.cell == start && (d ^ 1) == game.getDir()) continue;
+                int x = node.cell % width, y = node.cell / width;
+                game.moveCell(x, y, (INPUT_TYPE)d);
+                uint32_t next = (uint32_t)y * width + x;
+                if (game.isSnake(x, y) || node.g + 1 >= g[next]) continue;
+                g[next] = node.g + 1;
+                open.push(Node{ node.g + 1 + heuristic(x, y, foodX, foodY), node.g + 1, next });
+            }
+        }
+        return -1;
+    }
+};
+
+struct Latency
+{
+    std::vector<double> samples;
+
+    double mean() const
+    {
+        double total = 0;
+        for (double sample : samples) total += sample;
+        return samples.empty() ? 0 : total / samples.size();
+    }
+    double percentile(double p)
+    {
+        if (samples.empty()) return 0;
+        std::sort(samples.begin(), samples.end());
+        return samples[std::min(samples.size() - 1, (size_t)(p * samples.size()))];
+    }
+};
+
+int main(void)
+{
+    bool allOk = true;
+    printf("%6s %6s %7s %7s | %12s %12s %12s %10s | %12s %12s %12s %10s | %6s\n", "board", "foods", "length", "ticks",
+        "D* mean (us)", "D* p99 (us)", "D* max (us)", "exp/tick", "A* mean (us)", "A* p99 (us)", "A* max (us)", "exp/tick", "match");
+
+    for (int size : { 64, 128, 256, 512, 1024 }) {
+        GameConfig config{ size, size, false, std::max(1, size / 4) };
+        SnakeGL game(config, SnakeRng(size));
+        DStarLite pilot(config);
+        NaiveAStar astar(size, size);
+        Latency dstarTimes, astarTimes;
+        int foods = 0, ticks = 0, mismatches = 0;
+
+        for (; ticks < TICKS && !game.isGameOver(); ticks++) {
+            auto start = std::chrono::steady_clock::now();
+            INPUT_TYPE action = pilot.decide(game);
+            auto mid = std::chrono::steady_clock::now();
+            int distance = astar.distance(game);
+            auto end = std::chrono::steady_clock::now();
+            dstarTimes.samples.push_back(std::chrono::duration<double, std::micro>(mid - start).count());
+            astarTimes.samples.push_back(std::chrono::duration<double, std::micro>(end - mid).count());
+
+            if (pilot.getPathLength() != distance) {
+                if (mismatches++ == 0) {
+                    printf("  tick %d: D* Lite path %d, A* distance %d\n", ticks, pilot.getPathLength(), distance);
+                }
+            }
+            if (game.step(action).status == ATE_FOOD) foods++;
+        }
+        allOk = allOk && mismatches == 0;
+
+        printf("%4dx%-4d %3d %7d %7d | %12.1f %12.1f %12.1f %10.1f | %12.1f %12.1f %12.1f %10.1f | %6s\n", size, size, foods,
+            game.getLength(), ticks, dstarTimes.mean(), dstarTimes.percentile(0.99), dstarTimes.percentile(1.0),
+            (double)pilot.getExpanded() / ticks, astarTimes.mean(), astarTimes.percentile(0.99), astarTimes.percentile(1.0),
+            (double)astar.expanded / ticks, mismatches ? "NO" : "yes");
+    }
+    return allOk ? 0 : 1;
+}
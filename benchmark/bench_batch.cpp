@@ -0,0 +1,147 @@
+// Batched stepping: checks SnakeBatch against SnakeGL move by move, then
+// reports game-steps per second for every kernel the CPU supports.
+
+#include <stdio.h>
+
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <common/snakegl.hpp>
+#include <common/snakebatch.hpp>
+
+static const char* kernelName(SnakeBatch::KERNEL kernel)
+{
+    switch (kernel)
+    {
+    case SnakeBatch::KERNEL_AVX2: return "avx2";
+    case SnakeBatch::KERNEL_SSE2: return "sse2";
+    default: return "scalar";
+    }
+}
+
+// Same game in both engines: compare head, food, score and every body segment
+static bool sameState(const SnakeGL& snake, const SnakeBatch& batch, int game)
+{
+    if (batch.getHeadX(game) != snake.getHead().x || batch.getHeadY(game) != snake.getHead().y) return false;
+    if (batch.getFoodX(game) != snake.getFood().x || batch.getFoodY(game) != snake.getFood().y) return false;
+    if (batch.getScore(game) != snake.getScore() || batch.getDir(game) != snake.getDir()) return false;
+    if (batch.getLength(game) != snake.getLength()) return false;
+
+    // SnakeGL walks from the tail tip, the batch counts from the head
+    bool same = true;
+    int i = snake.getLength() - 1;
+    snake.forEachSegment([&](int x, int y) {
+        same = same && batch.getSegment(game, i--) == y * WIDTH + x;
+    });
+    return same;
+}
+
+// Runs SnakeGL games next to the batch with identical actions and identical
+// random streams, a finished SnakeGL game is replaced by one that continues
+// the stream just like the batch slot does.
+static bool verify(SnakeBatch::KERNEL kernel)
+{
+    const int games = 37; // not a multiple of the vector width, covers the scalar tail
+    const int ticks = 20000;
+
+    const uint64_t seed = 1234;
+
+    SnakeBatch batch(games, WIDTH, HEIGHT, seed);
+    batch.setKernel(kernel);
+    std::vector<std::unique_ptr<SnakeGL>> snakes(games);
+    for (int game = 0; game < games; game++) {
+        snakes[game].reset(new SnakeGL(SnakeRng(seed, game)));
+    }
+
+    std::mt19937 gen(42);
+    std::vector<uint8_t> actions(games);
+    int gamesOver = 0;
+
+    for (int t = 0; t < ticks; t++) {
+        for (int game = 0; game < games; game++) {
+            // Mostly head for the food so the snakes get long, sometimes turn at random
+            const SnakeGL& snake = *snakes[game];
+            INPUT_TYPE action;
+            if (gen() % 4 == 0) action = (INPUT_TYPE)(gen() % 4);
+            else if (snake.getFood().x != snake.getHead().x) action = snake.getFood().x > snake.getHead().x ? RIGHT : LEFT;
+            else action = snake.getFood().y > snake.getHead().y ? DOWN : UP;
+            actions[game] = (uint8_t)action;
+        }
+
+        batch.step(actions.data());
+
+        for (int game = 0; game < games; game++) {
+            StepResult result = snakes[game]->step((INPUT_TYPE)actions[game]);
+            if (batch.getStatus()[game] != result.status) {
+                printf("FAIL %s: game %d tick %d status %d != %d\n", kernelName(kernel), game, t, batch.getStatus()[game], result.status);
+                return false;
+            }
+
+            if (result.status == GAME_OVER) {
+                if (batch.getFinalScores()[game] != result.score) {
+                    printf("FAIL %s: game %d tick %d final score\n", kernelName(kernel), game, t);
+                    return false;
+                }
+                gamesOver++;
+                snakes[game].reset(new SnakeGL(snakes[game]->getRng()));
+            }
+
+            if (!sameState(*snakes[game], batch, game)) {
+                printf("FAIL %s: game %d tick %d state differs\n", kernelName(kernel), game, t);
+                return false;
+            }
+        }
+    }
+
+    printf("verify %-6s ok (%d games, %d ticks, %d game overs)\n", kernelName(kernel), games, ticks, gamesOver);
+    return true;
+}
+
+static double throughput(SnakeBatch::KERNEL kernel, int games)
+{
+    SnakeBatch batch(games);
+    batch.setKernel(kernel);
+
+    // A handful of pre-generated action rows so generating input is not measured
+    const int rows = 64;
+    std::mt19937 gen(7);
+    std::vector<uint8_t> actions((size_t)rows * games);
+    for (uint8_t& action : actions) action = (uint8_t)(gen() % 4);
+
+    int ticks = std::max(50, 20000000 / games);
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; t++) {
+        batch.step(&actions[(size_t)(t % rows) * games]);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return (double)games * ticks / std::chrono::duration<double>(end - start).count();
+}
+
+int main(void)
+{
+    std::vector<SnakeBatch::KERNEL> kernels = { SnakeBatch::KERNEL_SCALAR };
+    SnakeBatch probe(1);
+    if (probe.setKernel(SnakeBatch::KERNEL_SSE2)) kernels.push_back(SnakeBatch::KERNEL_SSE2);
+    if (probe.setKernel(SnakeBatch::KERNEL_AVX2)) kernels.push_back(SnakeBatch::KERNEL_AVX2);
+
+    for (SnakeBatch::KERNEL kernel : kernels) {
+        if (!verify(kernel)) return 1;
+    }
+
+    printf("\nGame-steps per second on a %dx%d board\n", WIDTH, HEIGHT);
+    printf("%8s", "games");
+    for (SnakeBatch::KERNEL kernel : kernels) printf(" %14s", kernelName(kernel));
+    printf("\n");
+
+    const int sizes[] = { 1024, 16384, 65536 };
+    for (int games : sizes) {
+        printf("%8d", games);
+        for (SnakeBatch::KERNEL kernel : kernels) printf(" %14.3e", throughput(kernel, games));
+        printf("\n");
+    }
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+// Runtime board sizes: memory held by one game and the cost of a tick on
+// 20x20, 1024x1024 and 8192x8192 boards.
+
+#include <stdio.h>
+
+#include <chrono>
+#include <memory>
+
+#include <common/snakegl.hpp>
+
+constexpr int TICKS = 2000000;
+
+static const char* pageName(PAGE_KIND kind)
+{
+    switch (kind)
+    {
+    case PAGES_HUGE: return "huge";
+    case PAGES_TRANSPARENT_HUGE: return "transparent huge";
+    default: return "normal";
+    }
+}
+
+int main(void)
+{
+    const int sizes[] = { 20, 1024, 8192 };
+
+    printf("%6s %12s %12s %12s %12s  %s\n", "board", "cells", "memory (MB)", "bytes/cell", "tick (ns)", "cell pages");
+    for (int size : sizes) {
+        auto start = std::chrono::steady_clock::now();
+        std::unique_ptr<SnakeGL> snake(new SnakeGL(size, size, 5));
+        double setup = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        // Mow the board row by row: never runs into itself until the board is nearly full
+        int column = 0;
+        int games = 1;
+        start = std::chrono::steady_clock::now();
+        for (int t = 0; t < TICKS; t++) {
+            INPUT_TYPE action = RIGHT;
+            if (++column == size) {
+                action = DOWN;
+                column = 0;
+            }
+            if (snake->step(action).status == GAME_OVER) {
+                snake.reset(new SnakeGL(size, size, 5 + games++));
+                column = 0;
+            }
+        }
+        double tick = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / TICKS;
+
+        double cells = (double)size * size;
+        double bytes = (double)snake->memoryBytes();
+        printf("%6d %12.0f %12.2f %12.3f %12.2f  %s (setup %.1f ms, %d games)\n", size, cells, bytes / (1024 * 1024),
+            bytes / cells, tick, pageName(snake->getCellPageKind()), setup, games);
+    }
+
+    return 0;
+}
@@ -0,0 +1,67 @@
+// Per-tick cost of SnakeGL::step() by snake length, from 10 up to a board
+// with a single free cell. The snake is grown along a Hamiltonian cycle, then
+// restored into a game with growth 0 so its length stays put while the timed
+// ticks run; the actions are worked out beforehand, only step() is timed.
+
+#include <stdio.h>
+
+#include <chrono>
+#include <vector>
+
+#include <common/hamiltonian.hpp>
+#include <common/snakegl.hpp>
+
+constexpr int SIZE = 64;
+constexpr int TICKS = 1000000;
+
+struct BodyRun
+{
+    double ns;      // Per tick
+    bool ok;        // Every tick moved and the length never changed
+};
+
+static BodyRun benchLength(int length)
+{
+    // Grow the snake to length, untimed
+    GameConfig growing{ SIZE, SIZE, false, 1 };
+    SnakeGL game(growing, SnakeRng(11));
+    HamiltonianPilot pilot(growing);
+    while (!game.isGameOver() && game.getLength() < length) game.step(pilot.decide(game));
+    std::vector<uint8_t> snapshot(game.snapshotBytes());
+    game.snapshot(snapshot.data());
+
+    // Same position, but eating no longer grows the snake
+    GameConfig constant = growing;
+    constant.growth = 0;
+    SnakeGL timed(constant, SnakeRng(11));
+    HamiltonianPilot constantPilot(constant);
+    timed.restore(snapshot.data());
+    std::vector<INPUT_TYPE> actions(TICKS);
+    for (INPUT_TYPE& action : actions) {
+        action = constantPilot.decide(timed);
+        timed.step(action);
+    }
+
+    timed.restore(snapshot.data());
+    bool ok = game.getLength() == length;
+    auto start = std::chrono::steady_clock::now();
+    for (INPUT_TYPE action : actions) ok &= timed.step(action).status != GAME_OVER;
+    auto end = std::chrono::steady_clock::now();
+    ok = ok && timed.getLength() == length;
+    return BodyRun{ std::chrono::duration<double, std::nano>(end - start).count() / TICKS, ok };
+}
+
+int main(void)
+{
+    const int lengths[] = { 10, 100, 1000, SIZE * SIZE - 1 };
+
+    printf("SnakeGL::step() on a %dx%d board, %d ticks per length\n", SIZE, SIZE, TICKS);
+    printf("%8s %14s %8s\n", "length", "tick (ns)", "check");
+    bool allOk = true;
+    for (int length : lengths) {
+        BodyRun run = benchLength(length);
+        allOk = allOk && run.ok;
+        printf("%8d %14.2f %8s\n", length, run.ns, run.ok ? "ok" : "WRONG");
+    }
+    return allOk ? 0 : 1;
+}
@@ -0,0 +1,93 @@
+// EnvPool scaling: game-steps per second from one worker up to one per core,
+// synchronous (step everything, wait for everything) and asynchronous (always
+// take back the first quarter of the games that finish).
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <common/envpool.hpp>
+
+constexpr double SECONDS = 0.5;
+
+static std::vector<uint8_t> randomActions(size_t count)
+{
+    std::mt19937 gen(3);
+    std::vector<uint8_t> actions(count);
+    for (uint8_t& action : actions) action = (uint8_t)(gen() % 4);
+    return actions;
+}
+
+static double benchSync(EnvPool& pool)
+{
+    int games = pool.getNumGames();
+    std::vector<uint8_t> actions = randomActions(games);
+    std::vector<EnvResult> results(games);
+
+    long long steps = 0;
+    auto start = std::chrono::steady_clock::now();
+    double elapsed = 0;
+    do {
+        pool.step(actions.data(), results.data());
+        steps += games;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < SECONDS);
+
+    return steps / elapsed;
+}
+
+static double benchAsync(EnvPool& pool)
+{
+    int games = pool.getNumGames();
+    int k = std::max(1, games / 4);
+    std::vector<uint8_t> actions = randomActions(games);
+    std::vector<int32_t> ids(games);
+    std::vector<EnvResult> results(k);
+    for (int game = 0; game < games; game++) ids[game] = game;
+
+    pool.send(ids.data(), actions.data(), games);
+
+    long long steps = 0;
+    auto start = std::chrono::steady_clock::now();
+    double elapsed = 0;
+    do {
+        pool.recv(results.data(), k);
+        for (int i = 0; i < k; i++) ids[i] = results[i].game;
+        pool.send(ids.data(), actions.data(), k);
+        steps += k;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < SECONDS);
+
+    // Drain what is still in flight before the pool is destroyed
+    for (int left = games; left > 0; left -= k) {
+        pool.recv(results.data(), std::min(k, left));
+    }
+
+    return steps / elapsed;
+}
+
+int main(void)
+{
+    int cores = std::max(1, (int)std::thread::hardware_concurrency());
+
+    struct Board { int size, games; };
+    const Board boards[] = { { 20, 4096 }, { 256, 256 } };
+
+    for (const Board& board : boards) {
+        printf("%dx%d board, %d games\n", board.size, board.size, board.games);
+        printf("%8s %16s %16s\n", "threads", "sync steps/s", "async steps/s");
+        for (int threads = 1; threads <= cores; threads = threads < cores ? std::min(cores, threads * 2) : cores + 1) {
+            EnvPool pool(board.games, threads, board.size, board.size);
+            double sync = benchSync(pool);
+            double async = benchAsync(pool);
+            printf("%8d %16.3e %16.3e\n", threads, sync, async);
+        }
+        printf("\n");
+    }
+
+    return 0;
+}
@@ -0,0 +1,147 @@
+// Bit-parallel flood fill against a scalar queue-based BFS on wrapping boards
+// from 256x256 to 8192x8192. About a quarter of every board is covered by short
+// random snake-like walls. Every fill is checked cell by cell against the BFS.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <common/floodfill.hpp>
+#include <common/snakerng.hpp>
+
+constexpr double MIN_SECONDS = 0.5;
+
+// Short random walks (snakes) that turn often, until a quarter of the board is blocked
+static void buildWalls(Bitboard& blocked, SnakeRng& rng)
+{
+    const int width = blocked.getWidth(), height = blocked.getHeight();
+    const int dx[4] = { 0, 0, -1, 1 };
+    const int dy[4] = { -1, 1, 0, 0 };
+    size_t target = (size_t)width * height / 4, count = 0;
+    while (count < target) {
+        int x = rng.nextInRange(0, width - 1), y = rng.nextInRange(0, height - 1);
+        int dir = rng.nextInRange(0, 3);
+        int length = rng.nextInRange(8, 48);
+        for (int i = 0; i < length && count < target; i++) {
+            if (!blocked.test(x, y)) {
+                blocked.set(x, y);
+                count++;
+            }
+            if (rng.nextInRange(0, 2) == 0) dir = rng.nextInRange(0, 3);
+            x = (x + dx[dir] + width) % width;
+            y = (y + dy[dir] + height) % height;
+        }
+    }
+}
+
+// Reference: one cell at a time through a FIFO queue
+class ScalarBFS
+{
+private:
+    int width, height;
+    std::vector<uint32_t> queue;
+
+public:
+    std::vector<uint8_t> visited;
+
+    ScalarBFS(int _width, int _height)
+        : width(_width), height(_height), queue((size_t)_width * _height), visited((size_t)_width * _height) {}
+
+    size_t fill(const Bitboard& blocked, int startX, int startY)
+    {
+        std::fill(visited.begin(), visited.end(), 0);
+        size_t head = 0, tail = 0;
+        uint32_t start = (uint32_t)startY * width + startX;
+        visited[start] = 1;
+        queue[tail++] = start;
+        while (head < tail) {
+            uint32_t cell = queue[head++];
+            int x = cell % width, y = cell / width;
+            const int nx[4] = { x, x, x == 0 ? width - 1 : x - 1, x == width - 1 ? 0 : x + 1 };
+            const int ny[4] = { y == 0 ? height - 1 : y - 1, y == height - 1 ? 0 : y + 1, y, y };
+            for (int d = 0; d < 4; d++) {
+                uint32_t next = (uint32_t)ny[d] * width + nx[d];
+                if (visited[next] || blocked.test(nx[d], ny[d])) continue;
+                visited[next] = 1;
+                queue[tail++] = next;
+            }
+        }
+        return tail;
+    }
+};
+
+// Mean milliseconds of fn(), repeated for at least MIN_SECONDS
+template <typename F>
+static double timeRepeated(F fn)
+{
+    int runs = 0;
+    auto start = std::chrono::steady_clock::now();
+    double elapsed = 0;
+    do {
+        fn();
+        runs++;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < MIN_SECONDS);
+    return elapsed * 1000 / runs;
+}
+
+int main(void)
+{
+    const int cores = std::max(1, (int)std::thread::hardware_concurrency());
+    std::vector<int> threadCounts{ 1 };
+    for (int t = 2; t <= std::max(4, cores); t *= 2) threadCounts.push_back(t);
+    bool allOk = true;
+
+    printf("%d hardware threads\n", cores);
+    printf("%10s %12s %12s", "board", "reached", "scalar (ms)");
+    for (int t : threadCounts) printf("   %2d thr (ms) speedup", t);
+    printf("  match\n");
+
+    for (int size : { 256, 1024, 2048, 4096, 8192 }) {
+        SnakeRng rng(size);
+        Bitboard blocked(size, size);
+        buildWalls(blocked, rng);
+        // Start on a free cell of a large region: the best of a few tries
+        ScalarBFS bfs(size, size);
+        int x = 0, y = 0;
+        size_t largest = 0;
+        for (int tries = 0; tries < 8; tries++) {
+            int cx = rng.nextInRange(0, size - 1), cy = rng.nextInRange(0, size - 1);
+            if (blocked.test(cx, cy)) continue;
+            size_t region = bfs.fill(blocked, cx, cy);
+            if (region > largest) {
+                largest = region;
+                x = cx;
+                y = cy;
+            }
+        }
+
+        size_t expected = 0;
+        double scalarMs = timeRepeated([&]() { expected = bfs.fill(blocked, x, y); });
+        printf("%4dx%-5d %12zu %12.2f", size, size, expected, scalarMs);
+
+        FloodFill flood(size, size, true);
+        bool ok = true;
+        for (int threads : threadCounts) {
+            size_t count = 0;
+            double ms = timeRepeated([&]() { count = flood.fill(blocked, x, y, threads); });
+            printf("   %11.2f %7.1fx", ms, scalarMs / ms);
+
+            ok = ok && count == expected;
+            for (int cy = 0; cy < size && ok; cy++) {
+                for (int cx = 0; cx < size; cx++) {
+                    if (flood.isReached(cx, cy) != (bfs.visited[(size_t)cy * size + cx] != 0)) {
+                        ok = false;
+                        break;
+                    }
+                }
+            }
+        }
+        printf("  %s\n", ok ? "yes" : "NO");
+        allOk = allOk && ok;
+    }
+    return allOk ? 0 : 1;
+}
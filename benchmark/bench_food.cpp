@@ -0,0 +1,62 @@
+// Food spawn cost against board fill ratio: sampling the free-cell counts vs.
+// drawing random cells until one is not covered by the snake.
+
+#include <stdio.h>
+
+#include <chrono>
+
+#include <common/bitboard.hpp>
+#include <common/freecells.hpp>
+#include <common/snakerng.hpp>
+
+constexpr int SIZE = 256;
+constexpr int SPAWNS = 200000;
+
+int main(void)
+{
+    const double fills[] = { 0.0, 0.5, 0.9, 0.99, 0.999, 0.9999 };
+    const int cells = SIZE * SIZE;
+
+    printf("Food spawn on a %dx%d board\n", SIZE, SIZE);
+    printf("%8s %12s %18s %18s\n", "fill", "free cells", "free counts (ns)", "rejection (ns)");
+
+    for (double fill : fills) {
+        // Cover the requested share of cells, picked at random
+        Bitboard occupied(SIZE, SIZE);
+        FreeCells freeCells(occupied);
+        SnakeRng rng(99);
+        int taken = (int)(fill * cells);
+        for (int i = 0; i < taken; i++) {
+            uint32_t cell = freeCells.sample(occupied, rng);
+            occupied.set(cell % SIZE, cell / SIZE);
+            freeCells.take(cell % SIZE, cell / SIZE);
+        }
+
+        uint64_t sink = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < SPAWNS; i++) {
+            sink += freeCells.sample(occupied, rng);
+        }
+        auto middle = std::chrono::steady_clock::now();
+
+        // Rejection gets fewer spawns, on a nearly full board each one takes thousands of draws
+        int rejectionSpawns = SPAWNS / 100;
+        for (int i = 0; i < rejectionSpawns; i++) {
+            int x, y;
+            do {
+                x = rng.nextInRange(0, SIZE - 1);
+                y = rng.nextInRange(0, SIZE - 1);
+            } while (occupied.test(x, y));
+            sink += x + y;
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        volatile uint64_t keep = sink;
+        (void)keep;
+        printf("%8.4f %12zu %18.2f %18.2f\n", fill, freeCells.size(),
+            std::chrono::duration<double, std::nano>(middle - start).count() / SPAWNS,
+            std::chrono::duration<double, std::nano>(end - middle).count() / rejectionSpawns);
+    }
+
+    return 0;
+}
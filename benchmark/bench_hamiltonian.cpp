@@ -0,0 +1,104 @@
+// Hamiltonian-cycle autopilot: cycle construction on large, odd and wrapping
+// boards (every cycle is walked and checked), then whole games played until
+// the snake covers the board, ending with the 64x64 demo game. Reports wall
+// time and the decision cost per tick.
+
+#include <stdio.h>
+
+#include <chrono>
+
+#include <common/hamiltonian.hpp>
+#include <common/snakegl.hpp>
+
+// Walk the cycle from (0, 0): every step must go to the next cycle position
+// and the walk must come back after exactly width * height steps
+static bool checkCycle(const HamiltonianPilot& pilot, bool walls)
+{
+    const int width = pilot.getWidth(), height = pilot.getHeight();
+    const uint64_t cells = (uint64_t)width * height;
+    int x = 0, y = 0;
+    for (uint64_t step = 0; step < cells; step++) {
+        uint32_t position = pilot.cycleIndex(x, y);
+        switch (pilot.cycleDirection(x, y)) {
+        case UP: y--; break;
+        case DOWN: y++; break;
+        case LEFT: x--; break;
+        default: x++; break;
+        }
+        if (x < 0 || y < 0 || x >= width || y >= height) {
+            if (walls) return false;
+            x = (x + width) % width;
+            y = (y + height) % height;
+        }
+        if (pilot.cycleIndex(x, y) != (uint32_t)((position + 1) % cells)) return false;
+    }
+    return x == 0 && y == 0;
+}
+
+struct GameRun
+{
+    bool full;          // The snake covers the board
+    uint64_t ticks;
+    double seconds;
+    double decideNs;    // Mean decision time per tick
+    uint64_t shortcuts;
+};
+
+static GameRun playToFullBoard(const GameConfig& config, uint64_t seed)
+{
+    SnakeGL game(config, SnakeRng(seed));
+    HamiltonianPilot pilot(config);
+    const int cells = config.width * config.height;
+    double decideNs = 0;
+    uint64_t ticks = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    while (!game.isGameOver() && game.getLength() < cells) {
+        auto before = std::chrono::steady_clock::now();
+        INPUT_TYPE action = pilot.decide(game);
+        decideNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - before).count();
+        game.step(action);
+        ticks++;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return GameRun{ game.getLength() == cells, ticks, seconds, ticks ? decideNs / ticks : 0, pilot.getShortcuts() };
+}
+
+int main(void)
+{
+    bool allOk = true;
+
+    printf("Cycle construction\n");
+    printf("%12s %6s %10s %8s\n", "board", "edges", "build (ms)", "cycle");
+    const GameConfig boards[] = {
+        { 1024, 1024, true, 1 }, { 1023, 1024, true, 1 }, { 1024, 1023, true, 1 }, { 1023, 1023, false, 1 },
+        { 4096, 4096, false, 1 }, { 4095, 4095, false, 1 }, { 3, 3, false, 1 }, { 2, 7, true, 1 },
+    };
+    for (const GameConfig& config : boards) {
+        auto start = std::chrono::steady_clock::now();
+        HamiltonianPilot pilot(config);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        bool ok = pilot.isValid() && checkCycle(pilot, config.walls);
+        allOk = allOk && ok;
+        printf("%5dx%-6d %6s %10.2f %8s\n", config.width, config.height, config.walls ? "walls" : "wrap", ms, ok ? "ok" : "BROKEN");
+    }
+    // Both sides odd with walls has no cycle
+    bool refused = !HamiltonianPilot(GameConfig{ 15, 15, true, 1 }).isValid();
+    allOk = allOk && refused;
+    printf("%5dx%-6d %6s %10s %8s\n", 15, 15, "walls", "-", refused ? "none ok" : "WRONG");
+
+    printf("\nGames to a full board\n");
+    printf("%12s %6s %6s %12s %10s %12s %10s %8s\n", "board", "edges", "growth", "ticks", "wall (s)", "decide (ns)", "shortcuts", "full");
+    const GameConfig games[] = {
+        { 20, 20, false, 1 }, { 15, 15, false, 1 }, { 21, 14, true, 1 }, { 17, 23, false, 3 }, { 32, 32, true, 4 },
+        { 64, 64, false, 1 },
+    };
+    for (const GameConfig& config : games) {
+        GameRun run = playToFullBoard(config, 7);
+        allOk = allOk && run.full;
+        printf("%5dx%-6d %6s %6d %12llu %10.3f %12.1f %10llu %8s\n", config.width, config.height, config.walls ? "walls" : "wrap",
+            config.growth, (unsigned long long)run.ticks, run.seconds, run.decideNs, (unsigned long long)run.shortcuts,
+            run.full ? "yes" : "NO");
+    }
+    return allOk ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+// Incremental Zobrist hashing: long random games checked tick by tick against
+// a from-scratch recomputation (all 8 symmetries, through undo as well), then
+// the tick cost with one hash and with all 8 symmetric hashes.
+
+#include <stdio.h>
+
+#include <chrono>
+
+#include <common/snakegl.hpp>
+
+constexpr int CHECK_TICKS = 200000;
+constexpr int TIMED_TICKS = 3000000;
+
+// Random move that does not kill the snake if there is one
+static INPUT_TYPE randomSafeAction(const SnakeGL& game, SnakeRng& rng)
+{
+    int first = rng.nextInRange(0, 3);
+    for (int i = 0; i < 4; i++) {
+        INPUT_TYPE action = (INPUT_TYPE)((first + i) & 3);
+        if ((action ^ 1) == game.getDir()) continue;
+        int x = game.getHead().x, y = game.getHead().y;
+        game.moveCell(x, y, action);
+        if (!game.isSnake(x, y)) return action;
+    }
+    return game.getDir();
+}
+
+static bool hashesMatch(const SnakeGL& game)
+{
+    const SnakeState& state = game.getState();
+    for (int s = 0; s < state.hashes; s++) {
+        if (state.hash[s] != game.computeHash(s)) return false;
+    }
+    return true;
+}
+
+// Every checkEvery ticks compare the incremental hashes with a full recomputation
+static bool verify(const GameConfig& config, int checkEvery, long long& checks)
+{
+    SnakeGL game(config, SnakeRng(21));
+    bool symmetric = game.setSymmetricHashing(true);
+    UndoLog log(8);
+    SnakeRng actions(8);
+
+    for (int t = 0; t < CHECK_TICKS; t++) {
+        // Every few ticks try a move and take it back first
+        if ((t & 7) == 0) {
+            game.step(randomSafeAction(game, actions), log);
+            game.undo(log);
+        }
+        if (game.step(randomSafeAction(game, actions)).status == GAME_OVER) {
+            game = SnakeGL(config, game.getRng());
+            game.setSymmetricHashing(symmetric);
+        }
+        if (t % checkEvery == 0) {
+            checks++;
+            if (!hashesMatch(game)) {
+                printf("  hash mismatch after %d ticks\n", t);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static double nsPerTick(const GameConfig& config, bool symmetric)
+{
+    SnakeGL game(config, SnakeRng(4));
+    game.setSymmetricHashing(symmetric);
+    SnakeRng actions(9);
+    uint64_t sink = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < TIMED_TICKS; t++) {
+        if (game.step(randomSafeAction(game, actions)).status == GAME_OVER) {
+            game = SnakeGL(config, game.getRng());
+            game.setSymmetricHashing(symmetric);
+        }
+        sink ^= game.getCanonicalHash();
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / TIMED_TICKS;
+    return sink == 42 ? ns + 1e-9 : ns;
+}
+
+int main(void)
+{
+    struct Case { const char* name; GameConfig config; int checkEvery; };
+    const Case cases[] = {
+        { "20x20 wrap", GameConfig{ 20, 20, false, 1 }, 1 },
+        { "20x20 walls", GameConfig{ 20, 20, true, 1 }, 1 },
+        { "64x64 wrap, growth 4", GameConfig{ 64, 64, false, 4 }, 16 },
+        { "100x60 wrap", GameConfig{ 100, 60, false, 1 }, 16 },
+    };
+
+    printf("%-24s %10s %8s %14s %16s\n", "board", "checks", "match", "1 hash (ns)", "8 hashes (ns)");
+    bool allOk = true;
+    for (const Case& c : cases) {
+        long long checks = 0;
+        bool ok = verify(c.config, c.checkEvery, checks);
+        allOk = allOk && ok;
+
+        double single = nsPerTick(c.config, false);
+        if (c.config.width == c.config.height) {
+            printf("%-24s %10lld %8s %14.2f %16.2f\n", c.name, checks, ok ? "yes" : "NO", single, nsPerTick(c.config, true));
+        }
+        else {
+            printf("%-24s %10lld %8s %14.2f %16s\n", c.name, checks, ok ? "yes" : "NO", single, "not square");
+        }
+    }
+
+    return allOk ? 0 : 1;
+}
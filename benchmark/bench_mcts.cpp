@@ -0,0 +1,101 @@
+// MCTS bot: playouts per second in both parallel modes as threads are added,
+// searching a mid-game 20x20 position with a 100 ms budget (inside the 90-150
+// ms tick window), then a game played with a fixed playout count per move to
+// show the bot eats, survives and keeps its tree between ticks.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <thread>
+
+#include <common/mcts.hpp>
+#include <common/snakegl.hpp>
+
+int main(void)
+{
+    bool allOk = true;
+    const GameConfig config{ 20, 20, false, 1 };
+
+    // Play a few foods in with a small search so the position has a body
+    SnakeGL position(config, SnakeRng(3));
+    {
+        MctsConfig quick;
+        quick.threads = 1;
+        quick.maxPlayouts = 300;
+        MctsPlanner planner(config, quick);
+        while (!position.isGameOver() && position.getScore() < 10) position.step(planner.decide(position));
+    }
+    if (position.isGameOver()) {
+        printf("Setup game ended early\n");
+        return 1;
+    }
+
+    printf("Playouts per second, 20x20 at length %d, %d ms tick\n", position.getLength(), position.getTickDuration());
+    printf("%6s %14s %14s\n", "threads", "tree parallel", "root parallel");
+    const int hardware = std::max(1, (int)std::thread::hardware_concurrency());
+    std::vector<int> counts{ 1 };
+    for (int t = 2; t <= hardware; t *= 2) counts.push_back(t);
+    if (counts.back() != hardware) counts.push_back(hardware);
+    for (int threads : counts) {
+        double rates[2];
+        for (int mode = 0; mode < 2; mode++) {
+            MctsConfig search;
+            search.mode = (MCTS_MODE)mode;
+            search.threads = threads;
+            search.budgetMs = 100;
+            MctsPlanner planner(config, search);
+            SnakeGL game(config, SnakeRng(1));
+            std::vector<uint8_t> start(position.snapshotBytes());
+            position.snapshot(start.data());
+            game.restore(start.data());
+            // Follow the bot for a few ticks, tree reuse included
+            uint64_t playouts = 0;
+            double seconds = 0;
+            for (int tick = 0; tick < 5 && !game.isGameOver(); tick++) {
+                game.step(planner.decide(game));
+                playouts += planner.getPlayouts();
+                seconds += planner.getSeconds();
+            }
+            rates[mode] = playouts / seconds;
+        }
+        printf("%6d %14.0f %14.0f\n", threads, rates[0], rates[1]);
+    }
+
+    // Budget from the tick length
+    {
+        MctsConfig search;
+        search.tickFraction = 0.5;
+        MctsPlanner planner(config, search);
+        planner.decide(position);
+        bool inTime = planner.getSeconds() * 1000 < position.getTickDuration();
+        allOk = allOk && inTime;
+        printf("\nHalf of a %d ms tick: searched %.1f ms, %llu playouts %s\n", position.getTickDuration(),
+            planner.getSeconds() * 1000, (unsigned long long)planner.getPlayouts(), inTime ? "ok" : "TOO SLOW");
+    }
+
+    // A game with a fixed playout count per move
+    MctsConfig search;
+    search.maxPlayouts = 2000;
+    MctsPlanner planner(config, search);
+    SnakeGL game(config, SnakeRng(11));
+    int ticks = 0, reusedTicks = 0;
+    uint64_t reusedNodes = 0, playouts = 0;
+    double seconds = 0;
+    while (!game.isGameOver() && ticks < 1000) {
+        game.step(planner.decide(game));
+        ticks++;
+        playouts += planner.getPlayouts();
+        seconds += planner.getSeconds();
+        if (planner.wasReused()) {
+            reusedTicks++;
+            reusedNodes += planner.getReusedNodes();
+        }
+    }
+    bool played = game.getScore() >= 20 && reusedTicks > ticks / 2;
+    allOk = allOk && played;
+    printf("\nGame, %llu playouts per move, %d threads\n", (unsigned long long)search.maxPlayouts, planner.getThreads());
+    printf("ticks %d, score %d, %s, tree kept on %d ticks (%.0f nodes on average), %.2f ms per move %s\n", ticks,
+        game.getScore(), game.isGameOver() ? "died" : "alive", reusedTicks, reusedTicks ? (double)reusedNodes / reusedTicks : 0.0,
+        seconds * 1000 / ticks, played ? "ok" : "WEAK");
+    return allOk ? 0 : 1;
+}
@@ -0,0 +1,121 @@
+// Replay recording and playback: cost of record() per tick, file size, time
+// to open a million-tick replay, and a check that playback reproduces the
+// recorded games exactly.
+
+#include <stdio.h>
+
+#include <chrono>
+#include <string>
+
+#include <common/replay.hpp>
+
+constexpr uint64_t LONG_TICKS = 1000000;
+
+// Row-by-row cycle through a wrapping board with an even number of rows: the
+// snake never runs into itself until it covers the whole board
+static INPUT_TYPE cycleAction(const SnakeGL& game)
+{
+    int x = game.getHead().x, y = game.getHead().y;
+    if (y % 2 == 0) return x == game.getWidth() - 1 ? DOWN : RIGHT;
+    return x == 0 ? DOWN : LEFT;
+}
+
+// Random move that does not kill the snake if there is one
+static INPUT_TYPE randomSafeAction(const SnakeGL& game, SnakeRng& rng)
+{
+    int first = rng.nextInRange(0, 3);
+    for (int i = 0; i < 4; i++) {
+        INPUT_TYPE action = (INPUT_TYPE)((first + i) & 3);
+        if ((action ^ 1) == game.getDir()) continue;
+        int x = game.getHead().x, y = game.getHead().y;
+        game.moveCell(x, y, action);
+        if (!game.isSnake(x, y)) return action;
+    }
+    return game.getDir();
+}
+
+template <typename Bot>
+static double playAndRecord(SnakeGL& game, ReplayWriter* writer, uint64_t maxTicks, Bot bot)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t t = 0; t < maxTicks && !game.isGameOver(); t++) {
+        INPUT_TYPE action = bot(game);
+        if (writer) writer->record(action);
+        game.step(action);
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool checkPlayback(const char* path, const SnakeGL& game, double& openUs, double& playMs)
+{
+    ReplayFile replay;
+    auto start = std::chrono::steady_clock::now();
+    if (!replay.open(path)) return false;
+    openUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    ReplayOutcome outcome = playReplay(replay);
+    playMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    const ReplayHeader& header = replay.getHeader();
+    return replay.isFinished() && header.rulesVersion == (uint32_t)RULES_VERSION &&
+        outcome.score == game.getScore() && outcome.score == header.finalScore &&
+        outcome.hash == game.getHash() && outcome.hash == header.finalHash &&
+        outcome.gameOver == game.isGameOver();
+}
+
+int main(void)
+{
+    const std::string path = "bench_replay.snkr";
+    bool allOk = true;
+
+    // A million-tick game on a 256x256 torus, with and without recording
+    {
+        GameConfig config{ 256, 256, false, 1 };
+        SnakeGL plain(config, SnakeRng(7));
+        double plainNs = playAndRecord(plain, nullptr, LONG_TICKS, cycleAction);
+
+        SnakeGL game(config, SnakeRng(7));
+        ReplayWriter writer(path.c_str(), config, SnakeRng(7));
+        double recordNs = playAndRecord(game, &writer, LONG_TICKS, cycleAction);
+        writer.close(game.getScore(), game.getHash());
+
+        double openUs = 0, playMs = 0;
+        bool ok = checkPlayback(path.c_str(), game, openUs, playMs);
+        allOk = allOk && ok;
+
+        printf("%llu ticks, score %d\n", (unsigned long long)writer.getTicks(), game.getScore());
+        printf("  tick without recording   %8.2f ns\n", plainNs / writer.getTicks());
+        printf("  tick with recording      %8.2f ns\n", recordNs / writer.getTicks());
+        printf("  file size                %8.1f KB (%.3f bits/tick)\n", (sizeof(ReplayHeader) + (writer.getTicks() + 3) / 4) / 1024.0,
+            (8.0 * (writer.getTicks() + 3) / 4 + 8.0 * sizeof(ReplayHeader)) / writer.getTicks());
+        printf("  open (mmap)              %8.1f us\n", openUs);
+        printf("  playback                 %8.1f ms\n", playMs);
+        printf("  score and hash match     %8s\n", ok ? "yes" : "NO");
+    }
+
+    // Many short games on other configs, each must replay to the same end
+    {
+        const GameConfig configs[] = { { 20, 20, false, 1 }, { 64, 64, true, 1 }, { 100, 60, false, 3 } };
+        SnakeRng actions(12);
+        int games = 0, matches = 0;
+        for (const GameConfig& config : configs) {
+            for (int g = 0; g < 50; g++) {
+                SnakeGL game(config, SnakeRng(100 + g, g));
+                {
+                    ReplayWriter writer(path.c_str(), config, SnakeRng(100 + g, g));
+                    playAndRecord(game, &writer, LONG_TICKS, [&](const SnakeGL& current) { return randomSafeAction(current, actions); });
+                    writer.close(game.getScore(), game.getHash());
+                }
+                double openUs, playMs;
+                games++;
+                if (checkPlayback(path.c_str(), game, openUs, playMs)) matches++;
+            }
+        }
+        printf("%d random games replayed, %d match\n", games, matches);
+        allOk = allOk && matches == games;
+    }
+
+    remove(path.c_str());
+    return allOk ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+// Specialized vs. generic ticks: the same games played once by the generic
+// SnakeGL and once by the instantiation dispatchSnakeGL picks for the config.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include <common/snakegl.hpp>
+
+constexpr int TICKS = 3000000;
+
+struct RunStats
+{
+    double nsPerTick;
+    long long totalScore;
+    int games;
+};
+
+// Cheap bot: head for the food, but never into the body or (with walls) off the board
+template <typename Game>
+INPUT_TYPE chooseAction(const Game& game, bool walls)
+{
+    static constexpr int dx[4] = { 0, 0, -1, 1 };
+    static constexpr int dy[4] = { -1, 1, 0, 0 };
+
+    int headX = game.getHead().x, headY = game.getHead().y;
+    INPUT_TYPE preferred[4] = {
+        game.getFood().x > headX ? RIGHT : LEFT,
+        game.getFood().y > headY ? DOWN : UP,
+        game.getDir(),
+        (INPUT_TYPE)(game.getDir() ^ 2) // a perpendicular turn
+    };
+    for (INPUT_TYPE action : preferred) {
+        if ((action ^ 1) == game.getDir()) continue;
+        int x = headX + dx[action], y = headY + dy[action];
+        if (walls && (x < 0 || y < 0 || x >= game.getWidth() || y >= game.getHeight())) continue;
+        x = (x + game.getWidth()) % game.getWidth();
+        y = (y + game.getHeight()) % game.getHeight();
+        if (!game.isSnake(x, y)) return action;
+    }
+    return game.getDir();
+}
+
+// Play TICKS ticks with the bot once and keep its actions, so the timed runs
+// below only measure step()
+std::vector<uint8_t> recordActions(const GameConfig& config, const SnakeRng& rng)
+{
+    std::vector<uint8_t> actions(TICKS);
+    SnakeGL game(config, rng);
+    for (int t = 0; t < TICKS; t++) {
+        actions[t] = (uint8_t)chooseAction(game, config.walls);
+        if (game.step((INPUT_TYPE)actions[t]).status == GAME_OVER) {
+            game = SnakeGL(config, game.getRng());
+        }
+    }
+    return actions;
+}
+
+template <typename Game>
+RunStats run(const Game& initial, const GameConfig& config, const std::vector<uint8_t>& actions)
+{
+    RunStats stats{ 1e30, 0, 0 };
+
+    // Best of a few rounds, the machine is shared
+    for (int round = 0; round < 3; round++) {
+        Game game = initial;
+        stats.totalScore = 0;
+        stats.games = 1;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int t = 0; t < TICKS; t++) {
+            StepResult result = game.step((INPUT_TYPE)actions[t]);
+            if (result.status == GAME_OVER) {
+                stats.totalScore += result.score;
+                stats.games++;
+                game = Game(config, game.getRng());
+            }
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / TICKS;
+        stats.nsPerTick = std::min(stats.nsPerTick, ns);
+        stats.totalScore += game.getScore();
+    }
+    return stats;
+}
+
+int main(void)
+{
+    const GameConfig configs[] = {
+        { 20, 20, false, 1 },
+        { 64, 64, true, 1 },
+        { 256, 256, false, 1 },
+        { 100, 60, false, 1 },  // no specialization, both runs are generic
+    };
+
+    printf("%-16s %14s %16s %8s %10s\n", "config", "generic (ns)", "specialized (ns)", "speedup", "same game");
+    for (const GameConfig& config : configs) {
+        SnakeRng rng(2024);
+        std::vector<uint8_t> actions = recordActions(config, rng);
+
+        SnakeGL generic(config, rng);
+        RunStats slow = run(generic, config, actions);
+
+        RunStats fast{};
+        dispatchSnakeGL(config, rng, [&](auto& game) {
+            fast = run(game, config, actions);
+        });
+
+        char name[32];
+        snprintf(name, sizeof(name), "%dx%d %s", config.width, config.height, config.walls ? "walls" : "wrap");
+        bool same = slow.totalScore == fast.totalScore && slow.games == fast.games;
+        printf("%-16s %14.2f %16.2f %7.2fx %10s\n", name, slow.nsPerTick, fast.nsPerTick,
+            slow.nsPerTick / fast.nsPerTick, same ? "yes" : "NO");
+        if (!same) return 1;
+    }
+
+    return 0;
+}
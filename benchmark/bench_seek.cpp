@@ -0,0 +1,122 @@
+// Keyframed replays: file size against seek latency for 100k-tick games at
+// several keyframe intervals. Every seek is checked against the state reached
+// by playing the replay from the start.
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <common/replay.hpp>
+
+constexpr uint64_t TICKS = 100000;
+constexpr int SEEKS = 200;
+
+// Row-by-row cycle through a wrapping board with an even number of rows: the
+// snake never runs into itself until it covers the whole board
+static INPUT_TYPE cycleAction(const SnakeGL& game)
+{
+    int x = game.getHead().x, y = game.getHead().y;
+    if (y % 2 == 0) return x == game.getWidth() - 1 ? DOWN : RIGHT;
+    return x == 0 ? DOWN : LEFT;
+}
+
+static long long fileSize(const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file) return -1;
+    fseek(file, 0, SEEK_END);
+    long long size = ftell(file);
+    fclose(file);
+    return size;
+}
+
+static void record(const char* path, const GameConfig& config, uint32_t interval)
+{
+    SnakeGL game(config, SnakeRng(17));
+    ReplayWriter writer(path, config, SnakeRng(17), interval);
+    for (uint64_t t = 0; t < TICKS; t++) {
+        INPUT_TYPE action = cycleAction(game);
+        writer.record(action);
+        game.step(action);
+        writer.keyframe(game);
+    }
+    writer.close(game.getScore(), game.getHash());
+}
+
+int main(void)
+{
+    const std::string path = "bench_seek.snkr";
+    const uint32_t intervals[] = { 0, 100, 1000, 10000 };
+    bool allOk = true;
+
+    for (int size : { 64, 256 }) {
+        GameConfig config{ size, size, false, 1 };
+
+        // Seek targets, and the state at each of them played from the start
+        SnakeRng rng(size);
+        std::vector<uint64_t> targets(SEEKS);
+        for (uint64_t& target : targets) target = (uint64_t)rng.nextInRange(0, (int)TICKS);
+        std::sort(targets.begin(), targets.end());
+
+        record(path.c_str(), config, 0);
+        std::vector<std::vector<uint8_t>> expected;
+        {
+            ReplayFile replay;
+            replay.open(path.c_str());
+            SnakeGL game(config, replay.getRng());
+            uint64_t tick = 0;
+            for (uint64_t target : targets) {
+                playActions(replay, game, tick, target);
+                tick = target;
+                expected.emplace_back(game.snapshotBytes());
+                game.snapshot(expected.back().data());
+            }
+        }
+
+        printf("%dx%d, %llu ticks\n", size, size, (unsigned long long)TICKS);
+        printf("%10s %10s %12s %14s %14s %8s\n", "interval", "keyframes", "size (KB)", "mean seek (us)", "max seek (us)", "match");
+        for (uint32_t interval : intervals) {
+            // Large boards with short intervals would need gigabytes (about 1.2 bytes per cell and keyframe)
+            if (interval && 5ull * size * size / 4 * (TICKS / interval) > (256ull << 20)) continue;
+
+            record(path.c_str(), config, interval);
+            ReplayFile replay;
+            if (!replay.open(path.c_str())) {
+                printf("%10u could not open the replay\n", interval);
+                allOk = false;
+                continue;
+            }
+
+            SnakeGL game(config, replay.getRng());
+            std::vector<uint8_t> state(game.snapshotBytes());
+            double total = 0, worst = 0;
+            bool ok = true;
+            // Visit the targets in random order so no seek profits from the previous one
+            std::vector<int> order(SEEKS);
+            for (int i = 0; i < SEEKS; i++) order[i] = i;
+            for (int i = SEEKS - 1; i > 0; i--) std::swap(order[i], order[rng.nextInRange(0, i)]);
+
+            for (int i : order) {
+                auto start = std::chrono::steady_clock::now();
+                seekReplay(replay, game, targets[i]);
+                double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+                total += us;
+                worst = std::max(worst, us);
+
+                game.snapshot(state.data());
+                ok = ok && memcmp(state.data(), expected[i].data(), state.size()) == 0;
+            }
+            allOk = allOk && ok;
+
+            printf("%10u %10zu %12.1f %14.1f %14.1f %8s\n", interval, replay.getKeyframeCount(), fileSize(path.c_str()) / 1024.0,
+                total / SEEKS, worst, ok ? "yes" : "NO");
+        }
+    }
+
+    remove(path.c_str());
+    return allOk ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+// Cloning games for lookahead: copy construction vs. snapshot()/restore() into
+// a preallocated arena vs. step() + undo(), at growing snake lengths.
+// Also checks that undo and restore put the game back bit for bit.
+
+#include <stdio.h>
+#include <string.h>
+
+#include <chrono>
+#include <vector>
+
+#include <common/snakegl.hpp>
+
+constexpr int REPEATS = 200000;
+constexpr int UNDO_DEPTH = 32;
+
+// Growth is huge, so after the first food the snake grows on every move
+static GameConfig growConfig(int size)
+{
+    GameConfig config;
+    config.width = config.height = size;
+    config.growth = size * size;
+    return config;
+}
+
+// Mow the board row by row until the snake is `length` cells long
+static SnakeGL growSnake(int size, int length)
+{
+    const GameConfig config = growConfig(size);
+    SnakeGL game(config, SnakeRng(11));
+
+    int column = 0;
+    while (game.getLength() < length) {
+        INPUT_TYPE action = RIGHT;
+        if (++column == size) {
+            action = DOWN;
+            column = 0;
+        }
+        game.step(action);
+    }
+    return game;
+}
+
+// Random walks of up to UNDO_DEPTH ticks, all taken back again
+static bool verifyUndo(SnakeGL game, std::vector<uint8_t>& before, std::vector<uint8_t>& after)
+{
+    UndoLog log(UNDO_DEPTH);
+    SnakeRng actions(3);
+    game.snapshot(before.data());
+    for (int round = 0; round < 2000; round++) {
+        int depth = actions.nextInRange(1, UNDO_DEPTH);
+        for (int i = 0; i < depth; i++) game.step((INPUT_TYPE)actions.nextInRange(0, 3), log);
+        while (!log.empty()) game.undo(log);
+        game.snapshot(after.data());
+        if (memcmp(before.data(), after.data(), before.size()) != 0) return false;
+    }
+    return true;
+}
+
+// A game restored from a snapshot plays on exactly like the original
+static bool verifyRestore(const SnakeGL& game, std::vector<uint8_t>& arena)
+{
+    SnakeGL original = game;
+    SnakeGL clone(growConfig(game.getWidth()), SnakeRng(99));
+    original.snapshot(arena.data());
+    clone.restore(arena.data());
+
+    SnakeRng actions(5);
+    for (int t = 0; t < 5000; t++) {
+        INPUT_TYPE action = (INPUT_TYPE)actions.nextInRange(0, 3);
+        StepResult a = original.step(action);
+        StepResult b = clone.step(action);
+        if (a.status != b.status || a.score != b.score) return false;
+        if (original.getHead().x != clone.getHead().x || original.getHead().y != clone.getHead().y) return false;
+        if (original.getFood().x != clone.getFood().x || original.getFood().y != clone.getFood().y) return false;
+        if (a.status == GAME_OVER) break;
+    }
+    return true;
+}
+
+template <typename F>
+static double nsPer(F fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < REPEATS; i++) fn(i);
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / REPEATS;
+}
+
+int main(void)
+{
+    struct Case { int size, length; };
+    const Case cases[] = { { 20, 1 }, { 20, 10 }, { 20, 100 }, { 20, 350 }, { 64, 1 }, { 64, 100 }, { 64, 1000 }, { 64, 3500 } };
+
+    printf("%6s %8s %10s %12s %12s %12s %14s  %s\n", "board", "length", "bytes", "copy (ns)", "snapshot (ns)", "restore (ns)",
+        "step+undo (ns)", "check");
+    bool allOk = true;
+    for (const Case& c : cases) {
+        SnakeGL game = growSnake(c.size, c.length);
+        std::vector<uint8_t> arena(game.snapshotBytes()), scratch(game.snapshotBytes());
+
+        bool ok = verifyUndo(game, arena, scratch) && verifyRestore(game, arena);
+        allOk = allOk && ok;
+
+        volatile int sink = 0;
+        double copy = nsPer([&](int) {
+            SnakeGL clone = game;
+            sink = sink + clone.getLength();
+        });
+        double snapshot = nsPer([&](int) { game.snapshot(arena.data()); });
+        SnakeGL target = game;
+        double restore = nsPer([&](int) { target.restore(arena.data()); });
+
+        // One lookahead ply: try a move, take it back
+        UndoLog log(UNDO_DEPTH);
+        double stepUndo = nsPer([&](int i) {
+            game.step((INPUT_TYPE)(i & 3), log);
+            game.undo(log);
+        });
+
+        printf("%6d %8d %10zu %12.1f %12.1f %12.1f %14.1f  %s\n", c.size, game.getLength(), game.snapshotBytes(), copy,
+            snapshot, restore, stepUndo, ok ? "ok" : "MISMATCH");
+    }
+
+    return allOk ? 0 : 1;
+}
@@ -0,0 +1,83 @@
+// Exhaustive small-board solver: positions, peak memory and time per board,
+// the score perfect play is sure to make, then the 4x4 table written, mapped
+// back and used as an oracle in real games with random food. Every position
+// of those games must be in the table and every game must make at least the
+// score the table promised at the start.
+
+#include <stdio.h>
+
+#include <chrono>
+
+#include <common/solver.hpp>
+
+int main(void)
+{
+    bool allOk = true;
+
+    printf("%8s %6s %12s %8s %8s %10s %10s %10s %8s\n", "board", "edges", "positions", "layers", "sweeps", "peak (MB)",
+        "enum (s)", "solve (s)", "score");
+    // 5x5 and up do not fit: they stop at the state limit
+    const GameConfig boards[] = { { 3, 3, true, 1 }, { 4, 4, true, 1 }, { 4, 4, true, 2 }, { 5, 4, true, 1 }, { 4, 4, false, 1 },
+        { 5, 5, true, 1 }, { 6, 6, true, 1 } };
+    const uint64_t maxStates = 12000000;
+    for (const GameConfig& config : boards) {
+        SmallBoardSolver solver(config, 0, maxStates);
+        bool solved = solver.solve();
+        const SolverStats& stats = solver.getStats();
+        char score[16] = "-";
+        if (solved) {
+            SolverValue start = solver.startValue();
+            snprintf(score, sizeof(score), "%d%s", solverScore(start), solverWin(start) ? " win" : "");
+        }
+        printf("%4dx%-3d %6s %11llu%s %8d %8llu %10.1f %10.2f %10.2f %8s\n", config.width, config.height,
+            config.walls ? "walls" : "wrap", (unsigned long long)stats.states, solved ? " " : "+", stats.layers,
+            (unsigned long long)stats.sweeps, stats.peakBytes / (1024.0 * 1024.0), stats.enumerateSeconds, stats.solveSeconds,
+            solved ? score : "limit");
+        // Everything up to 5x4 is solved
+        if (config.width * config.height <= 20) allOk = allOk && solved;
+    }
+
+    // Oracle from the mapped table
+    const GameConfig config{ 4, 4, true, 1 };
+    const char* path = "bench_solver.snks";
+    SmallBoardSolver solver(config);
+    SolverTable table;
+    if (!solver.solve() || !solver.writeTable(path) || !table.open(path)) {
+        printf("could not write and map %s\n", path);
+        return 1;
+    }
+    const int promised = solverScore(solver.startValue());
+    const bool promisedWin = solverWin(solver.startValue());
+
+    const int games = 1000;
+    int covered = 0, minScore = 1 << 30;
+    uint64_t lookups = 0, missing = 0;
+    double lookupNs = 0;
+    for (int g = 0; g < games; g++) {
+        SnakeGL game(config, SnakeRng(100 + g));
+        while (!game.isGameOver()) {
+            SolverValue value;
+            auto before = std::chrono::steady_clock::now();
+            bool found = table.lookup(game, value);
+            lookupNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - before).count();
+            lookups++;
+            if (!found) {
+                missing++;
+                break;
+            }
+            game.step(solverAction(value));
+        }
+        if (game.getLength() == config.width * config.height) covered++;
+        if (game.getScore() < minScore) minScore = game.getScore();
+    }
+    bool oracleOk = missing == 0 && minScore >= promised && (!promisedWin || covered == games);
+    allOk = allOk && oracleOk;
+    printf("\n4x4 walls table: %llu positions, %.1f MB mapped\n", (unsigned long long)table.getStateCount(),
+        table.getStateCount() * (sizeof(PackedState) + sizeof(SolverValue)) / (1024.0 * 1024.0));
+    printf("%d games with the oracle: %d covered the board, lowest score %d (promised %d%s), %.0f ns per lookup, %llu missing %s\n",
+        games, covered, minScore, promised, promisedWin ? " and a win" : "", lookupNs / lookups, (unsigned long long)missing,
+        oracleOk ? "ok" : "WRONG");
+
+    remove(path);
+    return allOk ? 0 : 1;
+}
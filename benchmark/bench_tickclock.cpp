@@ -0,0 +1,171 @@
+// Game loop timing: the old loop (sleep 1 ms, tick once the elapsed
+// milliseconds reach the tick duration) against TickClock sleeping until the
+// next deadline, like the playground's simulation thread. Reports the tick
+// interval error and how much that thread wakes and burns CPU while it has
+// nothing to do; the playground's render loop comes on top of it, once per
+// display refresh (or as fast as it can with --no-vsync). Then the same clock
+// with a render loop whose buffer swap waits for a 60 Hz vblank and now and
+// then stalls: on the game thread, and on its own thread behind a TripleBuffer.
+
+#include <stdio.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <thread>
+
+#include <common/tickclock.hpp>
+#include <common/triplebuffer.hpp>
+
+constexpr int TICK_MS = 30;
+constexpr int TICKS = 100;
+
+struct LoopRun
+{
+    TimingHistogram jitter;
+    uint64_t wakeups = 0;
+    double seconds = 0, cpuSeconds = 0;
+};
+
+static LoopRun pollingLoop()
+{
+    LoopRun run;
+    std::clock_t cpuStart = std::clock();
+    auto start = std::chrono::steady_clock::now();
+    auto lastUpdateTime = start;
+    for (int ticks = 0; ticks < TICKS;) {
+        auto currentTime = std::chrono::steady_clock::now();
+        auto elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - lastUpdateTime).count();
+        run.wakeups++;
+        if (elapsedTime >= TICK_MS) {
+            run.jitter.add(std::abs(std::chrono::duration<double, std::micro>(currentTime - lastUpdateTime).count() - TICK_MS * 1000.0));
+            lastUpdateTime = currentTime;
+            ticks++;
+        }
+        else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    run.cpuSeconds = (double)(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+    return run;
+}
+
+static LoopRun deadlineLoop()
+{
+    LoopRun run;
+    std::clock_t cpuStart = std::clock();
+    auto start = std::chrono::steady_clock::now();
+    TickClock clock(TICK_MS);
+    clock.start(start);
+    for (int ticks = 0; ticks < TICKS;) {
+        std::this_thread::sleep_until(clock.nextDeadline());
+        run.wakeups++;
+        ticks += clock.advance(std::chrono::steady_clock::now());
+    }
+    run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    run.cpuSeconds = (double)(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+    run.jitter = clock.getJitter();
+    return run;
+}
+
+// Stand-in for glfwSwapBuffers() with vsync: waits for the next 60 Hz vblank,
+// every tenth frame the driver takes 40 ms more
+static void swapBuffers(std::chrono::steady_clock::time_point start, uint64_t& frames)
+{
+    const std::chrono::duration<double, std::milli> frame(1000.0 / 60);
+    const auto now = std::chrono::steady_clock::now();
+    const uint64_t vblank = (uint64_t)((now - start) / frame) + 1;
+    std::this_thread::sleep_until(start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(frame * (double)vblank));
+    if (++frames % 10 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(40));
+}
+
+static LoopRun renderOnGameThread()
+{
+    LoopRun run;
+    std::clock_t cpuStart = std::clock();
+    auto start = std::chrono::steady_clock::now();
+    TickClock clock(TICK_MS);
+    clock.start(start);
+    uint64_t frames = 0;
+    for (int ticks = 0; ticks < TICKS;) {
+        std::this_thread::sleep_until(clock.nextDeadline());
+        run.wakeups++;
+        ticks += clock.advance(std::chrono::steady_clock::now());
+        swapBuffers(start, frames);
+    }
+    run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    run.cpuSeconds = (double)(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+    run.jitter = clock.getJitter();
+    return run;
+}
+
+static LoopRun renderOnOwnThread(bool& handOffOk)
+{
+    LoopRun run;
+    std::clock_t cpuStart = std::clock();
+    TripleBuffer<int> published;
+    std::atomic<bool> done{ false };
+    auto start = std::chrono::steady_clock::now();
+    TickClock clock(TICK_MS);
+    clock.start(start);
+
+    std::thread simulation([&]() {
+        for (int ticks = 0; ticks < TICKS;) {
+            std::this_thread::sleep_until(clock.nextDeadline());
+            run.wakeups++;
+            ticks += clock.advance(std::chrono::steady_clock::now());
+            published.writeSlot() = ticks;
+            published.publish();
+        }
+        done = true;
+    });
+    // The renderer only ever sees newer ticks
+    uint64_t frames = 0;
+    int seen = 0;
+    handOffOk = true;
+    while (!done) {
+        if (published.update()) {
+            handOffOk = handOffOk && published.readSlot() > seen;
+            seen = published.readSlot();
+        }
+        swapBuffers(start, frames);
+    }
+    simulation.join();
+    if (published.update()) seen = published.readSlot();
+    handOffOk = handOffOk && seen == TICKS;
+
+    run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    run.cpuSeconds = (double)(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+    run.jitter = clock.getJitter();
+    return run;
+}
+
+static void report(const char* name, const LoopRun& run)
+{
+    printf("%-24s %10.0f %10.0f %10.0f %12.0f %8.2f\n", name, run.jitter.getMean(), run.jitter.percentile(0.99),
+        run.jitter.getMax(), run.wakeups / run.seconds, 100.0 * run.cpuSeconds / run.seconds);
+}
+
+int main(void)
+{
+    printf("%d ticks of %d ms\n", TICKS, TICK_MS);
+    printf("%-24s %10s %10s %10s %12s %8s\n", "loop", "mean (us)", "p99 (us)", "max (us)", "wakeups/s", "CPU %");
+    LoopRun before = pollingLoop();
+    report("sleep 1 ms and poll", before);
+    LoopRun after = deadlineLoop();
+    report("sleep until the deadline", after);
+    // Every tick on time, with fewer wakeups than the polling loop
+    bool ok = after.jitter.getCount() == TICKS - 1 && after.wakeups < before.wakeups;
+
+    printf("\nWith a 60 Hz swap that stalls 40 ms every tenth frame\n");
+    LoopRun serial = renderOnGameThread();
+    report("swap on the game thread", serial);
+    bool handOffOk = false;
+    LoopRun threaded = renderOnOwnThread(handOffOk);
+    report("swap on its own thread", threaded);
+    ok = ok && handOffOk && threaded.jitter.getCount() == TICKS - 1;
+    printf("%s\n", ok ? "ok" : "WRONG");
+    return ok ? 0 : 1;
+}
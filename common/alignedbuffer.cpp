@@ -0,0 +1,71 @@
+#include <stdlib.h>
+
+#include <new>
+
+#include "alignedbuffer.hpp"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#elif defined(_WIN32)
+#include <malloc.h>
+#endif
+
+// Below this size huge pages are not worth it
+static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+static constexpr size_t CACHE_LINE = 64;
+
+static size_t roundUp(size_t bytes, size_t multiple)
+{
+    return (bytes + multiple - 1) / multiple * multiple;
+}
+
+void* allocateBoardMemory(size_t bytes, PAGE_KIND& kind)
+{
+    kind = PAGES_NORMAL;
+
+#if defined(__linux__)
+    if (bytes >= HUGE_PAGE_SIZE) {
+        size_t rounded = roundUp(bytes, HUGE_PAGE_SIZE);
+
+        // Explicit huge pages only exist if the admin reserved some
+        void* memory = mmap(nullptr, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (memory != MAP_FAILED) {
+            kind = PAGES_HUGE;
+            return memory;
+        }
+
+        // Otherwise ask for transparent huge pages on a 2 MB aligned block
+        memory = aligned_alloc(HUGE_PAGE_SIZE, rounded);
+        if (!memory) throw std::bad_alloc();
+        if (madvise(memory, rounded, MADV_HUGEPAGE) == 0) kind = PAGES_TRANSPARENT_HUGE;
+        return memory;
+    }
+#endif
+
+#if defined(_WIN32)
+    void* memory = _aligned_malloc(roundUp(bytes, CACHE_LINE), CACHE_LINE);
+#else
+    void* memory = aligned_alloc(CACHE_LINE, roundUp(bytes, CACHE_LINE));
+#endif
+    if (!memory) throw std::bad_alloc();
+    return memory;
+}
+
+void freeBoardMemory(void* memory, size_t bytes, PAGE_KIND kind)
+{
+#if defined(__linux__)
+    if (kind == PAGES_HUGE) {
+        munmap(memory, roundUp(bytes, HUGE_PAGE_SIZE));
+        return;
+    }
+#else
+    (void)bytes;
+    (void)kind;
+#endif
+
+#if defined(_WIN32)
+    _aligned_free(memory);
+#else
+    free(memory);
+#endif
+}
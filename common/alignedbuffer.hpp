@@ -0,0 +1,90 @@
+#ifndef ALIGNEDBUFFER_HPP
+#define ALIGNEDBUFFER_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+// Raw board memory: 64-byte (cache line) aligned, large blocks are backed by
+// huge pages when the OS has them (explicit huge pages first, then transparent
+// huge pages on Linux).
+enum PAGE_KIND
+{
+    PAGES_NORMAL,
+    PAGES_TRANSPARENT_HUGE,
+    PAGES_HUGE
+};
+
+void* allocateBoardMemory(size_t bytes, PAGE_KIND& kind);
+void freeBoardMemory(void* memory, size_t bytes, PAGE_KIND kind);
+
+// Fixed-size array of trivially copyable elements living in board memory
+template <typename T>
+class AlignedBuffer
+{
+    static_assert(std::is_trivially_copyable<T>::value, "AlignedBuffer holds plain data only");
+
+private:
+    T* items = nullptr;
+    size_t count = 0;
+    PAGE_KIND kind = PAGES_NORMAL;
+
+    void allocate(size_t _count)
+    {
+        count = _count;
+        items = count ? (T*)allocateBoardMemory(count * sizeof(T), kind) : nullptr;
+    }
+    void release()
+    {
+        if (items) freeBoardMemory(items, count * sizeof(T), kind);
+        items = nullptr;
+        count = 0;
+    }
+
+public:
+    AlignedBuffer() = default;
+    explicit AlignedBuffer(size_t _count, const T& value = T())
+    {
+        allocate(_count);
+        fill(value);
+    }
+    AlignedBuffer(const AlignedBuffer& other)
+    {
+        allocate(other.count);
+        if (count) memcpy(items, other.items, count * sizeof(T));
+    }
+    AlignedBuffer(AlignedBuffer&& other) noexcept
+        : items(other.items), count(other.count), kind(other.kind)
+    {
+        other.items = nullptr;
+        other.count = 0;
+    }
+    AlignedBuffer& operator=(AlignedBuffer other) noexcept
+    {
+        std::swap(items, other.items);
+        std::swap(count, other.count);
+        std::swap(kind, other.kind);
+        return *this;
+    }
+    ~AlignedBuffer() { release(); }
+
+    void fill(const T& value)
+    {
+        for (size_t i = 0; i < count; i++) items[i] = value;
+    }
+
+    inline T& operator[](size_t i) { return items[i]; }
+    inline const T& operator[](size_t i) const { return items[i]; }
+    inline T* data() { return items; }
+    inline const T* data() const { return items; }
+    inline T* begin() { return items; }
+    inline T* end() { return items + count; }
+    inline const T* begin() const { return items; }
+    inline const T* end() const { return items + count; }
+    inline size_t size() const { return count; }
+    inline size_t bytes() const { return count * sizeof(T); }
+    inline PAGE_KIND pageKind() const { return kind; }
+};
+
+#endif
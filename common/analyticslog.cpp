@@ -0,0 +1,228 @@
+#include <string.h>
+
+#include <algorithm>
+
+#include "analyticslog.hpp"
+
+// Helpers
+// ----------------------------------------------------------
+static const char* const COLUMN_NAMES[COLUMN_COUNT] = {
+    "tick", "head_x", "head_y", "length", "food_x", "food_y", "score", "latency"
+};
+
+static const char MAGIC[8] = { 'S', 'N', 'K', 'A', 0, 0, 0, 0 };
+
+static inline uint64_t zigzag(int64_t value)
+{
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static inline int64_t unzigzag(uint64_t value)
+{
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+// 64-bit words holding the deltas of a block, plus one so decoding may read a word past the end
+static inline size_t packedWords(uint32_t rows, uint32_t bitWidth)
+{
+    return rows > 1 ? ((size_t)(rows - 1) * bitWidth + 63) / 64 + 1 : 1;
+}
+// ----------------------------------------------------------
+
+// Function definitions
+// ----------------------------------------------------------
+const char* columnName(LOG_COLUMN column)
+{
+    return COLUMN_NAMES[column];
+}
+
+bool columnFromName(const char* name, LOG_COLUMN& column)
+{
+    for (int c = 0; c < COLUMN_COUNT; c++) {
+        if (strcmp(name, COLUMN_NAMES[c]) == 0) {
+            column = (LOG_COLUMN)c;
+            return true;
+        }
+    }
+    return false;
+}
+
+ColumnAverage averageWhere(const AnalyticsLog& log, LOG_COLUMN column, LOG_COLUMN where, int64_t value)
+{
+    std::vector<int64_t> keys(log.getBlockRows()), values(log.getBlockRows());
+    uint64_t matches = 0;
+    double sum = 0;
+
+    for (size_t b = 0; b < log.getBlockCount(); b++) {
+        const LogBlock& block = log.getBlock(b, where);
+        if (value < block.min || value > block.max) continue;
+
+        uint32_t rows = log.readBlock(b, where, keys.data());
+        bool decoded = false;
+        for (uint32_t i = 0; i < rows; i++) {
+            if (keys[i] != value) continue;
+            if (!decoded) {
+                log.readBlock(b, column, values.data());
+                decoded = true;
+            }
+            sum += (double)values[i];
+            matches++;
+        }
+    }
+    return ColumnAverage{ matches, matches ? sum / matches : 0.0 };
+}
+// ----------------------------------------------------------
+
+// Class definitions
+// ----------------------------------------------------------
+AnalyticsLogWriter::AnalyticsLogWriter(const char* path, int width, int height, uint32_t _blockRows)
+    : blockRows(std::min(std::max(_blockRows, 1u), MAX_BLOCK_ROWS))
+{
+    memset(&footer, 0, sizeof(footer));
+    footer.blockRows = blockRows;
+    footer.columns = COLUMN_COUNT;
+    footer.width = width;
+    footer.height = height;
+    memcpy(footer.magic, MAGIC, 4);
+    for (auto& column : pending) column.resize(blockRows);
+
+    file = fopen(path, "wb");
+    if (!file) return;
+    fwrite(MAGIC, sizeof(MAGIC), 1, file);
+    offset = sizeof(MAGIC);
+}
+
+AnalyticsLogWriter::~AnalyticsLogWriter()
+{
+    close();
+}
+
+void AnalyticsLogWriter::flushBlock()
+{
+    if (fill == 0) return;
+
+    for (int c = 0; c < COLUMN_COUNT; c++) {
+        const int64_t* values = pending[c].data();
+        LogBlock block;
+        block.offset = offset;
+        block.rows = fill;
+        block.first = block.min = block.max = values[0];
+
+        uint64_t bits = 0;
+        for (uint32_t i = 1; i < fill; i++) {
+            block.min = std::min(block.min, values[i]);
+            block.max = std::max(block.max, values[i]);
+            bits |= zigzag(values[i] - values[i - 1]);
+        }
+        block.bitWidth = 0;
+        while (block.bitWidth < 64 && (bits >> block.bitWidth) != 0) block.bitWidth++;
+
+        const uint32_t width = block.bitWidth;
+        packed.assign(packedWords(fill, width), 0);
+        if (width > 0) {
+            for (uint32_t i = 1; i < fill; i++) {
+                uint64_t delta = zigzag(values[i] - values[i - 1]);
+                size_t bit = (size_t)(i - 1) * width;
+                uint32_t shift = bit & 63;
+                packed[bit >> 6] |= delta << shift;
+                if (shift + width > 64) packed[(bit >> 6) + 1] |= delta >> (64 - shift);
+            }
+        }
+
+        if (file) fwrite(packed.data(), sizeof(uint64_t), packed.size(), file);
+        offset += packed.size() * sizeof(uint64_t);
+        index.push_back(block);
+    }
+    footer.blocks++;
+    fill = 0;
+}
+
+void AnalyticsLogWriter::close()
+{
+    if (!file) return;
+    flushBlock();
+    footer.indexOffset = offset;
+    footer.rows = rows;
+    fwrite(index.data(), sizeof(LogBlock), index.size(), file);
+    fwrite(&footer, sizeof(footer), 1, file);
+    fclose(file);
+    file = nullptr;
+}
+
+bool AnalyticsLog::open(const char* path)
+{
+    close();
+    if (!file.open(path) || file.getSize() < sizeof(MAGIC) + sizeof(LogFooter) ||
+        memcmp(file.getData(), MAGIC, sizeof(MAGIC)) != 0) {
+        close();
+        return false;
+    }
+
+    // Logs may be truncated or corrupt: check every offset and size before
+    // anything is read through it, comparing by division so nothing wraps
+    const size_t footerOffset = file.getSize() - sizeof(LogFooter);
+    footer = (const LogFooter*)(file.getData() + footerOffset);
+    if (memcmp(footer->magic, MAGIC, 4) != 0 || footer->columns != COLUMN_COUNT || footer->blockRows == 0 ||
+        footer->blockRows > AnalyticsLogWriter::MAX_BLOCK_ROWS || footer->indexOffset % 8 != 0 ||
+        footer->indexOffset > footerOffset ||
+        footer->blocks > (footerOffset - footer->indexOffset) / (COLUMN_COUNT * sizeof(LogBlock))) {
+        close();
+        return false;
+    }
+    index = (const LogBlock*)(file.getData() + footer->indexOffset);
+
+    // Every block decodes into getBlockRows() values from inside the packed data
+    for (size_t i = 0; i < (size_t)footer->blocks * COLUMN_COUNT; i++) {
+        const LogBlock& block = index[i];
+        if (block.rows == 0 || block.rows > footer->blockRows || block.bitWidth > 64 || block.offset % 8 != 0 ||
+            block.offset < sizeof(MAGIC) || block.offset > footer->indexOffset ||
+            packedWords(block.rows, block.bitWidth) > (footer->indexOffset - block.offset) / sizeof(uint64_t)) {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void AnalyticsLog::close()
+{
+    file.close();
+    footer = nullptr;
+    index = nullptr;
+}
+
+size_t AnalyticsLog::getColumnBytes(LOG_COLUMN column) const
+{
+    size_t bytes = 0;
+    for (size_t b = 0; b < getBlockCount(); b++) {
+        const LogBlock& block = getBlock(b, column);
+        bytes += packedWords(block.rows, block.bitWidth) * sizeof(uint64_t);
+    }
+    return bytes;
+}
+
+uint32_t AnalyticsLog::readBlock(size_t block, LOG_COLUMN column, int64_t* out) const
+{
+    const LogBlock& info = getBlock(block, column);
+    const uint64_t* packed = (const uint64_t*)(file.getData() + info.offset);
+    const uint32_t width = info.bitWidth;
+
+    int64_t value = info.first;
+    out[0] = value;
+    if (width == 0) {
+        std::fill(out + 1, out + info.rows, value);
+        return info.rows;
+    }
+
+    const uint64_t mask = width == 64 ? ~0ull : (1ull << width) - 1;
+    size_t bit = 0;
+    for (uint32_t i = 1; i < info.rows; i++, bit += width) {
+        uint32_t shift = bit & 63;
+        uint64_t delta = packed[bit >> 6] >> shift;
+        if (shift + width > 64) delta |= packed[(bit >> 6) + 1] << (64 - shift);
+        value += unzigzag(delta & mask);
+        out[i] = value;
+    }
+    return info.rows;
+}
+// ----------------------------------------------------------
@@ -0,0 +1,204 @@
+#ifndef ANALYTICSLOG_HPP
+#define ANALYTICSLOG_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "mappedfile.hpp"
+
+// Columnar per-tick log for analytics. Rows are cut into blocks of blockRows
+// rows; inside a block each column is stored on its own as deltas to the
+// previous value, zigzag encoded and bit-packed at the narrowest width that
+// fits the block. Every block keeps the min/max of each column, so a query
+// decodes only the columns it reads and skips blocks that can not match.
+//
+// File layout: "SNKA" magic, then per block the packed columns in LOG_COLUMN
+// order (8-byte aligned), then COLUMN_COUNT LogBlock entries per block, then
+// the LogFooter.
+
+enum LOG_COLUMN
+{
+    COLUMN_TICK,        // Tick inside the game, starts again at 0 for every game
+    COLUMN_HEAD_X,
+    COLUMN_HEAD_Y,
+    COLUMN_LENGTH,
+    COLUMN_FOOD_X,
+    COLUMN_FOOD_Y,
+    COLUMN_SCORE,
+    COLUMN_LATENCY,     // Time the player took to decide, nanoseconds
+    COLUMN_COUNT
+};
+
+const char* columnName(LOG_COLUMN column);
+// false if name is not a column
+bool columnFromName(const char* name, LOG_COLUMN& column);
+
+struct AnalyticsRow
+{
+    int64_t values[COLUMN_COUNT];
+
+    inline int64_t& operator[](LOG_COLUMN column) { return values[column]; }
+    inline int64_t operator[](LOG_COLUMN column) const { return values[column]; }
+};
+
+struct LogBlock
+{
+    uint64_t offset;    // File offset of the packed deltas
+    uint32_t rows;
+    uint32_t bitWidth;  // Bits per packed delta, 0 if all deltas are 0
+    int64_t first;      // Value of the first row, the deltas start at the second
+    int64_t min, max;
+};
+
+struct LogFooter
+{
+    uint64_t indexOffset;   // File offset of the LogBlock entries
+    uint64_t rows;
+    uint32_t blockRows;
+    uint32_t blocks;
+    uint32_t columns;       // COLUMN_COUNT of the writer
+    int32_t width, height;  // Board the games were played on
+    char magic[4];          // "SNKA"
+};
+
+// Appends rows and writes a block every blockRows rows, on the calling thread
+class AnalyticsLogWriter
+{
+public:
+    static constexpr uint32_t DEFAULT_BLOCK_ROWS = 65536;
+    static constexpr uint32_t MAX_BLOCK_ROWS = 1u << 24;   // Readers allocate this many values per column
+
+    AnalyticsLogWriter(const char* path, int width, int height, uint32_t blockRows = DEFAULT_BLOCK_ROWS);
+    ~AnalyticsLogWriter();
+
+    AnalyticsLogWriter(const AnalyticsLogWriter&) = delete;
+    AnalyticsLogWriter& operator=(const AnalyticsLogWriter&) = delete;
+
+    inline bool isOpen() const { return file != nullptr; }
+    inline uint64_t getRows() const { return rows; }
+
+    inline void append(const AnalyticsRow& row)
+    {
+        for (int c = 0; c < COLUMN_COUNT; c++) pending[c][fill] = row.values[c];
+        rows++;
+        if (++fill == blockRows) flushBlock();
+    }
+
+    // Write the last block, the index and the footer
+    void close();
+
+private:
+    FILE* file = nullptr;
+    LogFooter footer;
+    uint32_t blockRows;
+    uint32_t fill = 0;
+    uint64_t rows = 0;
+    uint64_t offset = 0;
+    std::vector<int64_t> pending[COLUMN_COUNT];
+    std::vector<uint64_t> packed;
+    std::vector<LogBlock> index;
+
+    void flushBlock();
+};
+
+// Read-only, memory mapped log
+class AnalyticsLog
+{
+public:
+    // false if the file is not an analytics log, or any block in it does not
+    // fit getBlockRows() or the file
+    bool open(const char* path);
+    void close();
+
+    inline bool isOpen() const { return file.isOpen(); }
+    inline uint64_t getRows() const { return footer->rows; }
+    inline size_t getBlockCount() const { return footer->blocks; }
+    inline uint32_t getBlockRows() const { return footer->blockRows; }
+    inline int getWidth() const { return footer->width; }
+    inline int getHeight() const { return footer->height; }
+    inline size_t getFileBytes() const { return file.getSize(); }
+
+    inline const LogBlock& getBlock(size_t block, LOG_COLUMN column) const
+    {
+        return index[block * COLUMN_COUNT + column];
+    }
+    // Packed bytes of a column over all blocks
+    size_t getColumnBytes(LOG_COLUMN column) const;
+
+    // Decode one block of a column into out (getBlockRows() values), returns its row count
+    uint32_t readBlock(size_t block, LOG_COLUMN column, int64_t* out) const;
+
+private:
+    MappedFile file;
+    const LogFooter* footer = nullptr;
+    const LogBlock* index = nullptr;
+};
+
+// Queries
+// ----------------------------------------------------------
+struct ColumnAverage
+{
+    uint64_t rows;      // Rows that matched
+    double average;
+};
+
+// Average of `column` over the rows where `where` equals value,
+// e.g. the average length at tick 500
+ColumnAverage averageWhere(const AnalyticsLog& log, LOG_COLUMN column, LOG_COLUMN where, int64_t value);
+
+// Last row of every game whose head is at most `distance` cells from an edge of
+// the board. fn(row index, row) gets every such row in order, with its tick,
+// head, length and score filled in. Returns the number of rows found.
+template <typename F>
+uint64_t deathsNearWalls(const AnalyticsLog& log, int distance, F fn);
+// ----------------------------------------------------------
+
+// Function definitions
+// ----------------------------------------------------------
+template <typename F>
+uint64_t deathsNearWalls(const AnalyticsLog& log, int distance, F fn)
+{
+    const int64_t lowX = distance, highX = (int64_t)log.getWidth() - 1 - distance;
+    const int64_t lowY = distance, highY = (int64_t)log.getHeight() - 1 - distance;
+    std::vector<int64_t> tick(log.getBlockRows()), x(log.getBlockRows()), y(log.getBlockRows());
+    std::vector<int64_t> length(log.getBlockRows()), score(log.getBlockRows());
+
+    uint64_t count = 0;
+    for (size_t b = 0; b < log.getBlockCount(); b++) {
+        // Blocks whose head never comes near an edge are skipped unread
+        const LogBlock& blockX = log.getBlock(b, COLUMN_HEAD_X);
+        const LogBlock& blockY = log.getBlock(b, COLUMN_HEAD_Y);
+        if (blockX.min > lowX && blockX.max < highX && blockY.min > lowY && blockY.max < highY) continue;
+
+        uint32_t rows = log.readBlock(b, COLUMN_TICK, tick.data());
+        log.readBlock(b, COLUMN_HEAD_X, x.data());
+        log.readBlock(b, COLUMN_HEAD_Y, y.data());
+        bool decoded = false;
+        for (uint32_t i = 0; i < rows; i++) {
+            // A game ends where the next row starts over at tick 0 (or the log ends)
+            int64_t next = i + 1 < rows ? tick[i + 1] : (b + 1 < log.getBlockCount() ? log.getBlock(b + 1, COLUMN_TICK).first : 0);
+            if (next != 0) continue;
+            if (x[i] > lowX && x[i] < highX && y[i] > lowY && y[i] < highY) continue;
+
+            if (!decoded) {
+                log.readBlock(b, COLUMN_LENGTH, length.data());
+                log.readBlock(b, COLUMN_SCORE, score.data());
+                decoded = true;
+            }
+            AnalyticsRow row{};
+            row[COLUMN_TICK] = tick[i];
+            row[COLUMN_HEAD_X] = x[i];
+            row[COLUMN_HEAD_Y] = y[i];
+            row[COLUMN_LENGTH] = length[i];
+            row[COLUMN_SCORE] = score[i];
+            fn((uint64_t)b * log.getBlockRows() + i, row);
+            count++;
+        }
+    }
+    return count;
+}
+// ----------------------------------------------------------
+
+#endif
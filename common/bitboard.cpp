@@ -0,0 +1,34 @@
+#include <bitset>
+#include <cstring>
+
+#include "bitboard.hpp"
+
+Bitboard::Bitboard(int _width, int _height)
+    : width(_width), height(_height), wordsPerRow((_width + 63) / 64),
+    words((size_t)_height * ((_width + 63) / 64), 0)
+{
+}
+
+void Bitboard::clear()
+{
+    words.fill(0);
+}
+
+size_t Bitboard::count() const
+{
+    size_t total = 0;
+    for (uint64_t word : words) {
+        total += std::bitset<64>(word).count();
+    }
+    return total;
+}
+
+void Bitboard::save(void* out) const
+{
+    memcpy(out, words.data(), words.bytes());
+}
+
+void Bitboard::load(const void* in)
+{
+    memcpy(words.data(), in, words.bytes());
+}
@@ -0,0 +1,51 @@
+#ifndef BITBOARD_HPP
+#define BITBOARD_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "alignedbuffer.hpp"
+
+// One bit per board cell. Every row starts on a fresh 64-bit word so a row
+// can be processed word by word without crossing into the next one.
+class Bitboard
+{
+private:
+    int width = 0, height = 0;
+    int wordsPerRow = 0;
+    AlignedBuffer<uint64_t> words;
+
+public:
+    Bitboard() = default;
+    Bitboard(int _width, int _height);
+
+    inline bool test(int x, int y) const
+    {
+        return (words[(size_t)y * wordsPerRow + (x >> 6)] >> (x & 63)) & 1;
+    }
+    inline void set(int x, int y)
+    {
+        words[(size_t)y * wordsPerRow + (x >> 6)] |= uint64_t(1) << (x & 63);
+    }
+    inline void reset(int x, int y)
+    {
+        words[(size_t)y * wordsPerRow + (x >> 6)] &= ~(uint64_t(1) << (x & 63));
+    }
+    void clear();
+
+    // Number of set bits on the whole board
+    size_t count() const;
+
+    inline int getWidth() const { return width; }
+    inline int getHeight() const { return height; }
+    inline int getWordsPerRow() const { return wordsPerRow; }
+    inline const uint64_t* row(int y) const { return &words[(size_t)y * wordsPerRow]; }
+    inline uint64_t* row(int y) { return &words[(size_t)y * wordsPerRow]; }
+    inline size_t bytes() const { return words.bytes(); }
+
+    // Raw copy of the words to/from bytes() bytes, the board size must match
+    void save(void* out) const;
+    void load(const void* in);
+};
+
+#endif
@@ -0,0 +1,308 @@
+#include <algorithm>
+#include <cstdlib>
+
+#include "dstarlite.hpp"
+
+// Class definitions
+// ----------------------------------------------------------
+DStarLite::DStarLite(const GameConfig& config)
+    : width(config.width), height(config.height), walls(config.walls)
+{
+    const size_t cells = (size_t)width * height;
+    g.resize(cells);
+    rhs.resize(cells);
+    heapIndex.resize(cells);
+    stamp.assign(cells, 0);
+}
+
+void DStarLite::reset()
+{
+    planned = false;
+    pathLength = -1;
+}
+
+INPUT_TYPE DStarLite::decide(const Bitboard& _occupied, int headX, int headY, int tailX, int tailY, int foodX, int foodY, INPUT_TYPE dir)
+{
+    occupied = &_occupied;
+    // The snake covers the whole board, there is nowhere left to go
+    if (foodX < 0) {
+        pathLength = -1;
+        return dir;
+    }
+
+    const uint32_t newStart = cellAt(headX, headY), newGoal = cellAt(foodX, foodY), newTail = cellAt(tailX, tailY);
+    const bool oneTick = planned && newGoal == goal && adjacent(start, newStart) && (newTail == tail || adjacent(tail, newTail));
+    if (!oneTick) {
+        start = newStart;
+        goal = newGoal;
+        tail = newTail;
+        initialize();
+    }
+    else {
+        const uint32_t oldHead = start, oldTail = tail;
+        start = newStart;
+        tail = newTail;
+        km += heuristic(last, start);
+        last = start;
+
+        // Only two cells changed: the old head joined the body (or was left
+        // behind by a snake of length 1) and the old tail tip may be free now.
+        // Their own rhs and that of every cell with an edge into them is stale.
+        for (uint32_t changed : { oldHead, oldTail }) {
+            for (int d = -1; d < 4; d++) {
+                uint32_t cell = changed;
+                if (d >= 0 && !neighbour(changed, d, cell)) continue;
+                if (cell == goal) continue;
+                touch(cell);
+                rhs[cell] = bestSuccessor(cell);
+                updateVertex(cell);
+            }
+            if (oldTail == oldHead) break;
+        }
+    }
+    computeShortestPath();
+
+    // Cheapest move the game accepts (never the reverse of dir), keeping the
+    // current direction on ties
+    const int reverse = dir ^ 1;
+    int bestCost = INF, bestDir = dir;
+    for (int i = 0; i < 4; i++) {
+        int d = (dir + i) & 3;
+        uint32_t next;
+        if (d == reverse || !neighbour(start, d, next)) continue;
+        int c = addCost(cost(start, next), stamp[next] == generation ? g[next] : INF);
+        if (c < bestCost) {
+            bestCost = c;
+            bestDir = d;
+        }
+    }
+    if (bestCost < INF) {
+        pathLength = bestCost;
+        return (INPUT_TYPE)bestDir;
+    }
+
+    // No way to the food: take the free cell with the most room around it
+    pathLength = -1;
+    int bestRoom = -1;
+    for (int d = 0; d < 4; d++) {
+        uint32_t next;
+        if (d == reverse || !neighbour(start, d, next) || blocked(next)) continue;
+        int room = 0;
+        for (int e = 0; e < 4; e++) {
+            uint32_t around;
+            if (neighbour(next, e, around) && around != start && !blocked(around)) room++;
+        }
+        if (room > bestRoom) {
+            bestRoom = room;
+            bestDir = d;
+        }
+    }
+    return (INPUT_TYPE)bestDir;
+}
+
+bool DStarLite::neighbour(uint32_t cell, int direction, uint32_t& out) const
+{
+    int x = cell % width, y = cell / width;
+    switch (direction) {
+    case UP:
+        if (y == 0 && walls) return false;
+        y = y == 0 ? height - 1 : y - 1;
+        break;
+    case DOWN:
+        if (y == height - 1 && walls) return false;
+        y = y == height - 1 ? 0 : y + 1;
+        break;
+    case LEFT:
+        if (x == 0 && walls) return false;
+        x = x == 0 ? width - 1 : x - 1;
+        break;
+    default:
+        if (x == width - 1 && walls) return false;
+        x = x == width - 1 ? 0 : x + 1;
+        break;
+    }
+    out = cellAt(x, y);
+    return true;
+}
+
+bool DStarLite::adjacent(uint32_t a, uint32_t b) const
+{
+    for (int d = 0; d < 4; d++) {
+        uint32_t cell;
+        if (neighbour(a, d, cell) && cell == b) return true;
+    }
+    return false;
+}
+
+int DStarLite::heuristic(uint32_t a, uint32_t b) const
+{
+    int dx = std::abs((int)(a % width) - (int)(b % width));
+    int dy = std::abs((int)(a / width) - (int)(b / width));
+    // Going around the torus may be shorter
+    if (!walls) {
+        dx = std::min(dx, width - dx);
+        dy = std::min(dy, height - dy);
+    }
+    return dx + dy;
+}
+
+void DStarLite::touch(uint32_t cell)
+{
+    if (stamp[cell] == generation) return;
+    stamp[cell] = generation;
+    g[cell] = rhs[cell] = INF;
+    heapIndex[cell] = -1;
+}
+
+DStarLite::Key DStarLite::calculateKey(uint32_t cell)
+{
+    int m = std::min(g[cell], rhs[cell]);
+    return Key{ addCost(m, heuristic(start, cell) + km), m };
+}
+
+int DStarLite::bestSuccessor(uint32_t cell)
+{
+    int bestCost = INF;
+    for (int d = 0; d < 4; d++) {
+        uint32_t next;
+        if (!neighbour(cell, d, next)) continue;
+        int c = addCost(cost(cell, next), stamp[next] == generation ? g[next] : INF);
+        bestCost = std::min(bestCost, c);
+    }
+    return bestCost;
+}
+
+void DStarLite::updateVertex(uint32_t cell)
+{
+    const bool queued = heapIndex[cell] >= 0;
+    if (g[cell] != rhs[cell]) {
+        if (queued) heapUpdate(cell, calculateKey(cell));
+        else heapPush(cell, calculateKey(cell));
+    }
+    else if (queued) {
+        heapRemove(cell);
+    }
+}
+
+void DStarLite::initialize()
+{
+    if (++generation == 0) {
+        // Stamps wrapped around, old ones could look current
+        std::fill(stamp.begin(), stamp.end(), 0);
+        generation = 1;
+    }
+    heap.clear();
+    km = 0;
+    last = start;
+    touch(goal);
+    rhs[goal] = 0;
+    heapPush(goal, calculateKey(goal));
+    planned = true;
+    searches++;
+}
+
+void DStarLite::computeShortestPath()
+{
+    touch(start);
+    while (!heap.empty() && (heap[0].key < calculateKey(start) || rhs[start] > g[start])) {
+        const uint32_t u = heap[0].cell;
+        const Key oldKey = heap[0].key;
+        const Key newKey = calculateKey(u);
+        expanded++;
+
+        if (oldKey < newKey) {
+            // km grew since u was queued
+            heapUpdate(u, newKey);
+        }
+        else if (g[u] > rhs[u]) {
+            // Overconsistent: settle u and offer it to its predecessors
+            g[u] = rhs[u];
+            heapRemove(u);
+            for (int d = 0; d < 4; d++) {
+                uint32_t s;
+                if (!neighbour(u, d, s) || s == goal) continue;
+                touch(s);
+                int c = addCost(cost(s, u), g[u]);
+                if (c < rhs[s]) {
+                    rhs[s] = c;
+                    updateVertex(s);
+                }
+            }
+        }
+        else {
+            // Underconsistent: u got more expensive, so did whatever went through it
+            const int oldG = g[u];
+            g[u] = INF;
+            for (int d = -1; d < 4; d++) {
+                uint32_t s = u;
+                if (d >= 0 && !neighbour(u, d, s)) continue;
+                if (s == goal) continue;
+                touch(s);
+                if (s == u || rhs[s] == addCost(cost(s, u), oldG)) rhs[s] = bestSuccessor(s);
+                updateVertex(s);
+            }
+        }
+    }
+}
+
+void DStarLite::place(int i, const HeapEntry& entry)
+{
+    heap[i] = entry;
+    heapIndex[entry.cell] = i;
+}
+
+void DStarLite::siftUp(int i)
+{
+    HeapEntry entry = heap[i];
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!(entry.key < heap[parent].key)) break;
+        place(i, heap[parent]);
+        i = parent;
+    }
+    place(i, entry);
+}
+
+void DStarLite::siftDown(int i)
+{
+    HeapEntry entry = heap[i];
+    const int count = (int)heap.size();
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= count) break;
+        if (child + 1 < count && heap[child + 1].key < heap[child].key) child++;
+        if (!(heap[child].key < entry.key)) break;
+        place(i, heap[child]);
+        i = child;
+    }
+    place(i, entry);
+}
+
+void DStarLite::heapPush(uint32_t cell, Key key)
+{
+    heap.push_back(HeapEntry{ key, cell });
+    siftUp((int)heap.size() - 1);
+}
+
+void DStarLite::heapUpdate(uint32_t cell, Key key)
+{
+    int i = heapIndex[cell];
+    const bool smaller = key < heap[i].key;
+    heap[i].key = key;
+    if (smaller) siftUp(i);
+    else siftDown(i);
+}
+
+void DStarLite::heapRemove(uint32_t cell)
+{
+    int i = heapIndex[cell];
+    heapIndex[cell] = -1;
+    HeapEntry moved = heap.back();
+    heap.pop_back();
+    if (i == (int)heap.size()) return;
+    heap[i] = moved;
+    heapIndex[moved.cell] = i;
+    if (i > 0 && moved.key < heap[(i - 1) / 2].key) siftUp(i);
+    else siftDown(i);
+}
+// ----------------------------------------------------------
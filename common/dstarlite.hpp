@@ -0,0 +1,110 @@
+#ifndef DSTARLITE_HPP
+#define DSTARLITE_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "bitboard.hpp"
+#include "snakerules.hpp"
+
+// Autopilot that steers the head along a shortest safe path to the food,
+// planned with D* Lite (Koenig & Likhachev). The search runs backward from
+// the food, so when the head moves only the heuristic offset km changes, and
+// when the snake moves only the two cells that changed (the old head joins
+// the body, the old tail tip is freed) are repaired instead of searching the
+// whole board again. A fresh search starts only when the food moves.
+//
+// Snake cells other than the head are walls to the planner. The board wraps
+// on every edge unless the GameConfig has walls.
+class DStarLite
+{
+public:
+    explicit DStarLite(const GameConfig& config);
+
+    // Action for the next tick: game.handleInput(pilot.decide(game)). Call
+    // once per tick; after anything but a single tick (a new game, a restore)
+    // the planner notices and starts over.
+    template <typename Game>
+    INPUT_TYPE decide(const Game& game)
+    {
+        return decide(game.getOccupancy(), game.getHead().x, game.getHead().y, game.getTailTip().x, game.getTailTip().y,
+            game.getFood().x, game.getFood().y, game.getDir());
+    }
+    INPUT_TYPE decide(const Bitboard& occupied, int headX, int headY, int tailX, int tailY, int foodX, int foodY, INPUT_TYPE dir);
+
+    // Forget the current plan, the next decide() searches from scratch
+    void reset();
+
+    // Length of the planned path from the head to the food, -1 if the food can not be reached
+    inline int getPathLength() const { return pathLength; }
+    // Cells expanded over all decisions, and fresh searches (new food or a reset)
+    inline uint64_t getExpanded() const { return expanded; }
+    inline uint64_t getSearches() const { return searches; }
+
+private:
+    static constexpr int INF = 1 << 29;
+
+    struct Key
+    {
+        int k1, k2;
+        inline bool operator<(const Key& other) const { return k1 < other.k1 || (k1 == other.k1 && k2 < other.k2); }
+    };
+
+    struct HeapEntry
+    {
+        Key key;
+        uint32_t cell;
+    };
+
+    int width, height;
+    bool walls;
+
+    // Per cell search state. Cells whose stamp is not the current generation
+    // count as g = rhs = INF and not queued, so a new search clears nothing.
+    std::vector<int> g, rhs;
+    std::vector<int> heapIndex;
+    std::vector<uint32_t> stamp;
+    uint32_t generation = 0;
+    std::vector<HeapEntry> heap;
+
+    const Bitboard* occupied = nullptr;
+    bool planned = false;
+    uint32_t start = 0, goal = 0;   // Head and food
+    uint32_t last = 0;              // Head when km was last updated
+    uint32_t tail = 0;
+    int km = 0;
+    int pathLength = -1;
+    uint64_t expanded = 0, searches = 0;
+
+    inline uint32_t cellAt(int x, int y) const { return (uint32_t)y * width + x; }
+    // Neighbour in a direction, false off the board with walls
+    bool neighbour(uint32_t cell, int direction, uint32_t& out) const;
+    bool adjacent(uint32_t a, uint32_t b) const;
+    int heuristic(uint32_t a, uint32_t b) const;
+    inline bool blocked(uint32_t cell) const
+    {
+        return cell != start && occupied->test(cell % width, cell / width);
+    }
+    // Sum of two costs where INF absorbs everything
+    static inline int addCost(int a, int b) { return a >= INF || b >= INF ? INF : a + b; }
+    // Cost of the move a -> b, INF if either end is blocked
+    inline int cost(uint32_t a, uint32_t b) const { return blocked(a) || blocked(b) ? INF : 1; }
+
+    void touch(uint32_t cell);
+    Key calculateKey(uint32_t cell);
+    // rhs from scratch: cheapest move out of cell plus g beyond it
+    int bestSuccessor(uint32_t cell);
+    void updateVertex(uint32_t cell);
+    void initialize();
+    void computeShortestPath();
+
+    // Indexed binary min-heap over cells
+    void heapPush(uint32_t cell, Key key);
+    void heapUpdate(uint32_t cell, Key key);
+    void heapRemove(uint32_t cell);
+    void siftUp(int i);
+    void siftDown(int i);
+    void place(int i, const HeapEntry& entry);
+};
+
+#endif
@@ -0,0 +1,193 @@
+#include <algorithm>
+
+#include "envpool.hpp"
+
+#if defined(__linux__)
+#include <pthread.h>
+#elif defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+// Helpers
+// ----------------------------------------------------------
+static void pinThread(std::thread& thread, int core)
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#elif defined(_WIN32)
+    SetThreadAffinityMask(thread.native_handle(), DWORD_PTR(1) << core);
+#else
+    (void)thread;
+    (void)core;
+#endif
+}
+// ----------------------------------------------------------
+
+// Class definitions
+// ----------------------------------------------------------
+EnvPool::Worker::Worker(int _first, int _count, int width, int height, uint64_t seed)
+    : first(_first), count(_count), batch(_count, width, height, seed, _first),
+    inbox(_count), pending(_count), actions(_count)
+{
+}
+
+EnvPool::EnvPool(int _numGames, int numThreads, int width, int height, uint64_t seed)
+    : numGames(_numGames), owner(_numGames), outbox(_numGames), ordered(_numGames)
+{
+    int cores = std::max(1, (int)std::thread::hardware_concurrency());
+    if (numThreads <= 0) numThreads = cores;
+    numThreads = std::min(numThreads, numGames);
+
+    for (int w = 0; w < numThreads; w++) {
+        int first = (int)((int64_t)numGames * w / numThreads);
+        int last = (int)((int64_t)numGames * (w + 1) / numThreads);
+        workers.emplace_back(new Worker(first, last - first, width, height, seed));
+        std::fill(owner.begin() + first, owner.begin() + last, w);
+    }
+
+    for (int w = 0; w < numThreads; w++) {
+        Worker& worker = *workers[w];
+        worker.thread = std::thread([this, &worker]() { run(worker); });
+        pinThread(worker.thread, w % cores);
+    }
+}
+
+EnvPool::~EnvPool()
+{
+    running.store(false, std::memory_order_release);
+    for (auto& worker : workers) {
+        {
+            std::lock_guard<std::mutex> guard(worker->lock);
+            worker->sleeping.store(false, std::memory_order_relaxed);
+        }
+        worker->wake.notify_one();
+        worker->thread.join();
+    }
+}
+
+void EnvPool::send(const int32_t* games, const uint8_t* actions, int count)
+{
+    for (int i = 0; i < count; i++) {
+        Worker& worker = *workers[owner[games[i]]];
+        Action action{ games[i] - worker.first, actions[i] };
+        while (!worker.inbox.push(action)) std::this_thread::yield();
+        notify(worker);
+    }
+}
+
+void EnvPool::send(const uint8_t* actions)
+{
+    for (auto& worker : workers) {
+        for (int local = 0; local < worker->count; local++) {
+            Action action{ local, actions[worker->first + local] };
+            while (!worker->inbox.push(action)) std::this_thread::yield();
+        }
+        notify(*worker);
+    }
+}
+
+int EnvPool::recv(EnvResult* out, int k)
+{
+    for (int i = 0; i < k; i++) {
+        while (!outbox.pop(out[i])) std::this_thread::yield();
+    }
+    return k;
+}
+
+void EnvPool::step(const uint8_t* actions, EnvResult* out)
+{
+    send(actions);
+    recv(ordered.data(), numGames);
+    for (const EnvResult& result : ordered) {
+        out[result.game] = result;
+    }
+}
+
+void EnvPool::notify(Worker& worker)
+{
+    // Pairs with the fence in park(): either the worker sees the pushed action
+    // or this sees it asleep
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!worker.sleeping.load(std::memory_order_relaxed)) return;
+    {
+        std::lock_guard<std::mutex> guard(worker.lock);
+        worker.sleeping.store(false, std::memory_order_relaxed);
+    }
+    worker.wake.notify_one();
+}
+
+bool EnvPool::park(Worker& worker)
+{
+    std::unique_lock<std::mutex> guard(worker.lock);
+    worker.sleeping.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (worker.inbox.pop(worker.pending[0])) {
+        worker.sleeping.store(false, std::memory_order_relaxed);
+        return true;
+    }
+    worker.wake.wait(guard, [&]() {
+        return !worker.sleeping.load(std::memory_order_relaxed) || !running.load(std::memory_order_acquire);
+    });
+    worker.sleeping.store(false, std::memory_order_relaxed);
+    return false;
+}
+
+void EnvPool::run(Worker& worker)
+{
+    SnakeBatch& batch = worker.batch;
+    int idle = 0;
+
+    while (running.load(std::memory_order_acquire)) {
+        int n = 0;
+        while (n < worker.count && worker.inbox.pop(worker.pending[n])) n++;
+
+        if (n == 0) {
+            // Spin a little, then give the core away, then sleep until send()
+            if (++idle <= SPIN_ROUNDS) continue;
+            if (idle <= SPIN_ROUNDS + YIELD_ROUNDS) {
+                std::this_thread::yield();
+                continue;
+            }
+            idle = 0;
+            if (!park(worker)) continue;
+            // park() caught an action on its last look at the inbox
+            n = 1;
+            while (n < worker.count && worker.inbox.pop(worker.pending[n])) n++;
+        }
+        idle = 0;
+
+        if (n == worker.count) {
+            // Every game of the shard has an action (each game is in flight at most once): use the SIMD kernels
+            for (int i = 0; i < n; i++) {
+                worker.actions[worker.pending[i].local] = (uint8_t)worker.pending[i].action;
+            }
+            batch.step(worker.actions.data());
+        }
+        else {
+            for (int i = 0; i < n; i++) {
+                batch.stepGame(worker.pending[i].local, (uint8_t)worker.pending[i].action);
+            }
+        }
+
+        for (int i = 0; i < n; i++) {
+            int local = worker.pending[i].local;
+            int status = batch.getStatus()[local];
+
+            EnvResult result;
+            result.game = worker.first + local;
+            result.status = status;
+            result.score = status == GAME_OVER ? batch.getFinalScores()[local] : batch.getScore(local);
+            result.headX = batch.getHeadX(local);
+            result.headY = batch.getHeadY(local);
+            result.foodX = batch.getFoodX(local);
+            result.foodY = batch.getFoodY(local);
+            result.length = batch.getLength(local);
+            while (!outbox.push(result)) std::this_thread::yield();
+        }
+    }
+}
+// ----------------------------------------------------------
@@ -0,0 +1,102 @@
+#ifndef ENVPOOL_HPP
+#define ENVPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "boundedqueue.hpp"
+#include "snakebatch.hpp"
+
+// What a consumer gets back for one stepped game
+struct EnvResult
+{
+    int32_t game;
+    int32_t status;     // STEP_STATUS of the step; GAME_OVER games are already reset
+    int32_t score;      // Score after the step, final score for GAME_OVER
+    int32_t headX, headY;
+    int32_t foodX, foodY;
+    int32_t length;
+};
+
+// N games sharded over worker threads, each worker owns a SnakeBatch with a
+// contiguous range of games. Actions and results travel through preallocated
+// lock-free queues, so stepping never allocates. Game i always uses random
+// stream i of the seed, results do not depend on the number of threads.
+//
+// Async use: send() actions for any set of games, then recv(k) returns the first
+// k games that finished stepping, whichever worker they live on. A game may only
+// be sent again after its result was received.
+//
+// A worker with nothing to do spins briefly, then sleeps until send() hands it
+// an action, so an idle pool (e.g. while the consumer trains) uses no CPU.
+class EnvPool
+{
+public:
+    // numThreads == 0 uses one worker per hardware thread
+    EnvPool(int _numGames, int numThreads = 0, int width = WIDTH, int height = HEIGHT, uint64_t seed = 1);
+    ~EnvPool();
+
+    EnvPool(const EnvPool&) = delete;
+    EnvPool& operator=(const EnvPool&) = delete;
+
+    void send(const int32_t* games, const uint8_t* actions, int count);
+    // One action per game, for all games
+    void send(const uint8_t* actions);
+    // Blocks until k results are available, writes them in completion order
+    int recv(EnvResult* out, int k);
+
+    // Synchronous step of every game, results are ordered by game id
+    void step(const uint8_t* actions, EnvResult* out);
+
+    inline int getNumGames() const { return numGames; }
+    inline int getNumThreads() const { return (int)workers.size(); }
+
+private:
+    struct Action
+    {
+        int32_t local;  // game index inside the worker's batch
+        int32_t action;
+    };
+
+    struct Worker
+    {
+        int first, count;
+        SnakeBatch batch;
+        BoundedQueue<Action> inbox;
+        std::vector<Action> pending;
+        std::vector<uint8_t> actions;
+        std::thread thread;
+        // Parking: sleeping is set under lock before the worker's last look at
+        // its inbox, send() checks it after pushing
+        std::atomic<bool> sleeping{ false };
+        std::mutex lock;
+        std::condition_variable wake;
+
+        Worker(int _first, int _count, int width, int height, uint64_t seed);
+    };
+
+    // Empty inbox polls before a worker yields, then before it parks
+    static constexpr int SPIN_ROUNDS = 64;
+    static constexpr int YIELD_ROUNDS = 256;
+
+    int numGames;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<int> owner;             // game -> worker
+    BoundedQueue<EnvResult> outbox;
+    std::vector<EnvResult> ordered;     // scratch for step()
+    std::atomic<bool> running{ true };
+
+    void run(Worker& worker);
+    // After pushing to worker's inbox: wake it if it is parked
+    void notify(Worker& worker);
+    // Sleep until notify() or the destructor. true instead if an action came in
+    // first, it is in worker.pending[0].
+    bool park(Worker& worker);
+};
+
+#endif
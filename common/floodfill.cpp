@@ -0,0 +1,281 @@
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <cstring>
+#include <thread>
+
+#include "floodfill.hpp"
+
+// Helpers
+// ----------------------------------------------------------
+// Kogge-Stone occluded fill: spread gen toward higher bits (higher x) through
+// the set bits of pro, in 6 steps for any run length
+static inline uint64_t spreadUp(uint64_t gen, uint64_t pro)
+{
+    gen |= pro & (gen << 1);
+    pro &= pro << 1;
+    gen |= pro & (gen << 2);
+    pro &= pro << 2;
+    gen |= pro & (gen << 4);
+    pro &= pro << 4;
+    gen |= pro & (gen << 8);
+    pro &= pro << 8;
+    gen |= pro & (gen << 16);
+    pro &= pro << 16;
+    gen |= pro & (gen << 32);
+    return gen;
+}
+
+// Same toward lower bits
+static inline uint64_t spreadDown(uint64_t gen, uint64_t pro)
+{
+    gen |= pro & (gen >> 1);
+    pro &= pro >> 1;
+    gen |= pro & (gen >> 2);
+    pro &= pro >> 2;
+    gen |= pro & (gen >> 4);
+    pro &= pro >> 4;
+    gen |= pro & (gen >> 8);
+    pro &= pro >> 8;
+    gen |= pro & (gen >> 16);
+    pro &= pro >> 16;
+    gen |= pro & (gen >> 32);
+    return gen;
+}
+
+static size_t countRows(const Bitboard& board, int first, int last)
+{
+    size_t total = 0;
+    for (int y = first; y < last; y++) {
+        const uint64_t* row = board.row(y);
+        for (int w = 0; w < board.getWordsPerRow(); w++) total += std::bitset<64>(row[w]).count();
+    }
+    return total;
+}
+
+// Rounds of the band threads are short, so they spin instead of sleeping
+class SpinBarrier
+{
+private:
+    std::atomic<int> arrived{ 0 };
+    std::atomic<int> generation{ 0 };
+    int count;
+
+public:
+    explicit SpinBarrier(int _count) : count(_count) {}
+
+    void wait()
+    {
+        int current = generation.load(std::memory_order_acquire);
+        if (arrived.fetch_add(1, std::memory_order_acq_rel) == count - 1) {
+            arrived.store(0, std::memory_order_relaxed);
+            generation.fetch_add(1, std::memory_order_release);
+            return;
+        }
+        while (generation.load(std::memory_order_acquire) == current) std::this_thread::yield();
+    }
+};
+// ----------------------------------------------------------
+
+// Class definitions
+// ----------------------------------------------------------
+FloodFill::FloodFill(int _width, int _height, bool _wrap)
+    : width(_width), height(_height), wrap(_wrap), wordsPerRow((_width + 63) / 64),
+    lastMask(_width % 64 ? (uint64_t(1) << (_width % 64)) - 1 : ~uint64_t(0)),
+    reached(_width, _height), pendingDown(_height), pendingUp(_height)
+{
+}
+
+size_t FloodFill::fill(const Bitboard& _blocked, int x, int y, int threads)
+{
+    blocked = &_blocked;
+    reached.clear();
+    std::fill(pendingDown.begin(), pendingDown.end(), 0);
+    std::fill(pendingUp.begin(), pendingUp.end(), 0);
+    reached.set(x, y);
+    fillRow(y);
+
+    threads = std::min(threads, height / 2);
+    if (threads > 1) {
+        std::vector<Band> bands(threads);
+        for (int b = 0; b < threads; b++) {
+            bands[b] = Band{ height * b / threads, height * (b + 1) / threads, false, false };
+            if (y >= bands[b].first && y < bands[b].last) markChanged(bands[b], y);
+        }
+        return fillBands(bands);
+    }
+
+    Band band{ 0, height, false, false };
+    markChanged(band, y);
+    settle(band);
+    return countRows(reached, 0, height);
+}
+
+bool FloodFill::touches(int x, int y) const
+{
+    if (reached.test(x, y)) return true;
+    const int dx[4] = { 0, 0, -1, 1 };
+    const int dy[4] = { -1, 1, 0, 0 };
+    for (int d = 0; d < 4; d++) {
+        int nx = x + dx[d], ny = y + dy[d];
+        if (wrap) {
+            nx = (nx + width) % width;
+            ny = (ny + height) % height;
+        }
+        else if (nx < 0 || ny < 0 || nx >= width || ny >= height) {
+            continue;
+        }
+        if (reached.test(nx, ny)) return true;
+    }
+    return false;
+}
+
+void FloodFill::fillRow(int y)
+{
+    uint64_t* row = reached.row(y);
+    const int last = wordsPerRow - 1;
+    const int topBit = (width - 1) & 63;
+
+    // Toward higher x, a carry bit moves the fill into the next word. On a
+    // torus a run can continue from the end of the row at its start, then
+    // a second pass picks it up there until the words stop changing.
+    for (int pass = 0; pass < (wrap ? 2 : 1); pass++) {
+        uint64_t carry = pass == 0 ? 0 : (row[last] >> topBit) & 1;
+        if (pass == 1 && !carry) break;
+        for (int w = 0; w <= last; w++) {
+            uint64_t free = freeWord(y, w);
+            uint64_t word = spreadUp(row[w] | (carry & free), free);
+            if (pass == 1 && word == row[w]) break;
+            row[w] = word;
+            carry = word >> 63;
+        }
+    }
+
+    // Toward lower x, the carry enters the previous word at its top bit
+    for (int pass = 0; pass < (wrap ? 2 : 1); pass++) {
+        uint64_t carry = pass == 0 ? 0 : row[0] & 1;
+        if (pass == 1 && !carry) break;
+        for (int w = last; w >= 0; w--) {
+            uint64_t free = freeWord(y, w);
+            uint64_t in = carry << (w == last ? topBit : 63);
+            uint64_t word = spreadDown(row[w] | (in & free), free);
+            if (pass == 1 && word == row[w]) break;
+            row[w] = word;
+            carry = word & 1;
+        }
+    }
+}
+
+bool FloodFill::pull(int y, const uint64_t* from)
+{
+    uint64_t* row = reached.row(y);
+    bool changed = false;
+    for (int w = 0; w < wordsPerRow; w++) {
+        uint64_t added = from[w] & freeWord(y, w) & ~row[w];
+        if (added) {
+            row[w] |= added;
+            changed = true;
+        }
+    }
+    if (changed) fillRow(y);
+    return changed;
+}
+
+void FloodFill::markChanged(Band& band, int y)
+{
+    pendingDown[y] = pendingUp[y] = 1;
+    if (y == band.first) band.topChanged = true;
+    if (y == band.last - 1) band.bottomChanged = true;
+}
+
+void FloodFill::settle(Band& band)
+{
+    // A band covering the whole torus also wraps from its last row to its first
+    const bool wrapRows = wrap && band.first == 0 && band.last == height;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int y = band.first + 1; y < band.last; y++) {
+            if (!pendingDown[y - 1]) continue;
+            pendingDown[y - 1] = 0;
+            if (pull(y, reached.row(y - 1))) {
+                markChanged(band, y);
+                changed = true;
+            }
+        }
+        if (wrapRows && pendingDown[height - 1]) {
+            pendingDown[height - 1] = 0;
+            if (pull(0, reached.row(height - 1))) {
+                markChanged(band, 0);
+                changed = true;
+            }
+        }
+        for (int y = band.last - 2; y >= band.first; y--) {
+            if (!pendingUp[y + 1]) continue;
+            pendingUp[y + 1] = 0;
+            if (pull(y, reached.row(y + 1))) {
+                markChanged(band, y);
+                changed = true;
+            }
+        }
+        if (wrapRows && pendingUp[0]) {
+            pendingUp[0] = 0;
+            if (pull(height - 1, reached.row(0))) {
+                markChanged(band, height - 1);
+                changed = true;
+            }
+        }
+    }
+}
+
+size_t FloodFill::fillBands(std::vector<Band>& bands)
+{
+    const int numBands = (int)bands.size();
+    for (auto& parity : edges) parity.assign((size_t)numBands * 2 * wordsPerRow, 0);
+    // Bands whose edges changed, per round modulo 3: a slot is cleared one
+    // round before it is counted and read one round after, never both at once
+    std::atomic<int> changes[3];
+    for (auto& slot : changes) slot.store(0, std::memory_order_relaxed);
+    std::vector<size_t> counts(numBands);
+    SpinBarrier barrier(numBands);
+
+    auto run = [&](int b) {
+        Band& band = bands[b];
+        const int above = b > 0 ? b - 1 : (wrap ? numBands - 1 : -1);
+        const int below = b < numBands - 1 ? b + 1 : (wrap ? 0 : -1);
+        for (int round = 0;; round++) {
+            // Take in what the neighbouring bands published last round
+            if (round > 0) {
+                const uint64_t* published = edges[(round - 1) & 1].data();
+                if (above >= 0 && pull(band.first, published + ((size_t)above * 2 + 1) * wordsPerRow)) {
+                    markChanged(band, band.first);
+                }
+                if (below >= 0 && pull(band.last - 1, published + (size_t)below * 2 * wordsPerRow)) {
+                    markChanged(band, band.last - 1);
+                }
+            }
+            settle(band);
+
+            uint64_t* out = edges[round & 1].data() + (size_t)b * 2 * wordsPerRow;
+            memcpy(out, reached.row(band.first), wordsPerRow * sizeof(uint64_t));
+            memcpy(out + wordsPerRow, reached.row(band.last - 1), wordsPerRow * sizeof(uint64_t));
+            if (band.topChanged || band.bottomChanged) changes[round % 3].fetch_add(1, std::memory_order_relaxed);
+            band.topChanged = band.bottomChanged = false;
+            if (b == 0) changes[(round + 1) % 3].store(0, std::memory_order_relaxed);
+
+            barrier.wait();
+            if (changes[round % 3].load(std::memory_order_relaxed) == 0) break;
+        }
+        counts[b] = countRows(reached, band.first, band.last);
+    };
+
+    std::vector<std::thread> workers;
+    for (int b = 1; b < numBands; b++) workers.emplace_back(run, b);
+    run(0);
+    for (std::thread& worker : workers) worker.join();
+
+    size_t total = 0;
+    for (size_t count : counts) total += count;
+    return total;
+}
+// ----------------------------------------------------------
@@ -0,0 +1,69 @@
+#ifndef FLOODFILL_HPP
+#define FLOODFILL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "bitboard.hpp"
+
+// Flood fill over a Bitboard of blocked cells, 64 cells per word: a row pulls
+// in the reached bits of the row above or below with one AND per word, then
+// spreads them along its free runs with shifts (Kogge-Stone fill inside a
+// word, a carry bit across words). Rows are swept down and up until nothing
+// changes, and only rows whose neighbour changed are looked at again.
+//
+// With several threads the rows are cut into bands. Each thread fills its
+// band on its own and swaps the band's first and last row with the
+// neighbouring bands between rounds, until a round changes no band edge.
+class FloodFill
+{
+public:
+    // wrap: the board is a torus (no walls), every edge connects to the opposite one
+    FloodFill(int _width, int _height, bool _wrap);
+
+    // Reach every cell connected to (x, y) through cells clear in blocked and
+    // return how many there are. The start cell is reached, and counted, even
+    // if it is blocked itself (e.g. the head). threads <= 1 fills on the
+    // calling thread.
+    size_t fill(const Bitboard& blocked, int x, int y, int threads = 1);
+
+    // Result of the last fill()
+    inline const Bitboard& getReached() const { return reached; }
+    inline bool isReached(int x, int y) const { return reached.test(x, y); }
+    // (x, y) or one of its neighbours was reached, e.g. the head can still get to its tail
+    bool touches(int x, int y) const;
+
+private:
+    struct Band
+    {
+        int first, last;        // Rows [first, last)
+        bool topChanged, bottomChanged;
+    };
+
+    int width, height;
+    bool wrap;
+    int wordsPerRow;
+    uint64_t lastMask;          // Valid bits of the last word of a row
+    const Bitboard* blocked = nullptr;
+    Bitboard reached;
+    std::vector<uint8_t> pendingDown, pendingUp; // Row changed since the row below / above pulled from it
+    std::vector<uint64_t> edges[2];              // Per round parity, first and last row of every band
+
+    inline uint64_t freeWord(int y, int w) const
+    {
+        uint64_t free = ~blocked->row(y)[w];
+        return w == wordsPerRow - 1 ? free & lastMask : free;
+    }
+    // Spread the reached bits of row y along its free runs
+    void fillRow(int y);
+    // reached[y] |= from & free[y], then fillRow(); true if row y changed
+    bool pull(int y, const uint64_t* from);
+    void markChanged(Band& band, int y);
+    // Sweep a band down and up until it stops changing
+    void settle(Band& band);
+    // Fill with one thread per band, returns the reached count
+    size_t fillBands(std::vector<Band>& bands);
+};
+
+#endif
@@ -0,0 +1,69 @@
+#include <bitset>
+#include <cstring>
+
+#include "freecells.hpp"
+
+FreeCells::FreeCells(const Bitboard& occupied)
+    : width(occupied.getWidth()), wordsPerRow(occupied.getWordsPerRow()),
+    lastWordMask(occupied.getWidth() % 64 ? (1ull << (occupied.getWidth() % 64)) - 1 : ~0ull),
+    small(((size_t)occupied.getHeight() * occupied.getWordsPerRow() + SMALL_WORDS - 1) / SMALL_WORDS),
+    large(((size_t)occupied.getHeight() * occupied.getWordsPerRow() + LARGE_WORDS - 1) / LARGE_WORDS)
+{
+    rebuild(occupied);
+}
+
+void FreeCells::rebuild(const Bitboard& occupied)
+{
+    small.fill(0);
+    large.fill(0);
+    count = 0;
+    const size_t words = (size_t)occupied.getHeight() * wordsPerRow;
+    for (size_t word = 0; word < words; word++) {
+        const uint32_t free = (uint32_t)std::bitset<64>(freeBits(occupied, word)).count();
+        small[word / SMALL_WORDS] += (uint16_t)free;
+        large[word / LARGE_WORDS] += free;
+        count += free;
+    }
+}
+
+uint32_t FreeCells::select(const Bitboard& occupied, uint64_t k) const
+{
+    size_t group = 0;
+    while (k >= large[group]) k -= large[group++];
+    size_t part = group * (LARGE_WORDS / SMALL_WORDS);
+    while (k >= small[part]) k -= small[part++];
+    size_t word = part * SMALL_WORDS;
+    uint64_t free = freeBits(occupied, word);
+    for (;;) {
+        const uint64_t bits = std::bitset<64>(free).count();
+        if (k < bits) break;
+        k -= bits;
+        free = freeBits(occupied, ++word);
+    }
+
+    // Drop the k lower free cells of the word, the lowest one left is the cell
+    for (; k > 0; k--) free &= free - 1;
+    const int bit = (int)std::bitset<64>((free & (0 - free)) - 1).count();
+    const int y = (int)(word / wordsPerRow);
+    const int x = (int)(word % wordsPerRow) * 64 + bit;
+    return (uint32_t)y * width + x;
+}
+
+void FreeCells::save(void* out) const
+{
+    uint8_t* bytesOut = (uint8_t*)out;
+    uint64_t size = count;
+    memcpy(bytesOut, &size, sizeof(size));
+    memcpy(bytesOut + sizeof(size), small.data(), small.bytes());
+    memcpy(bytesOut + sizeof(size) + small.bytes(), large.data(), large.bytes());
+}
+
+void FreeCells::load(const void* in)
+{
+    const uint8_t* bytesIn = (const uint8_t*)in;
+    uint64_t size;
+    memcpy(&size, bytesIn, sizeof(size));
+    count = (size_t)size;
+    memcpy(small.data(), bytesIn + sizeof(size), small.bytes());
+    memcpy(large.data(), bytesIn + sizeof(size) + small.bytes(), large.bytes());
+}
@@ -0,0 +1,82 @@
+#ifndef FREECELLS_HPP
+#define FREECELLS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "alignedbuffer.hpp"
+#include "bitboard.hpp"
+#include "snakerng.hpp"
+
+// The cells an occupancy Bitboard leaves clear, kept as counts only: free
+// cells per group of SMALL_WORDS bitboard words and per group of LARGE_WORDS
+// words. Taking or releasing a cell is two increments; a draw walks the large
+// groups, then the small ones, then at most SMALL_WORDS words of the bitboard
+// itself. The counts add under 0.01 bytes per cell to the board, a list of the
+// free cells with their positions cost 8.
+//
+// Draws pick the k-th free cell in cell order (y * width + x), so the same
+// occupancy and random stream always give the same food.
+class FreeCells
+{
+public:
+    static constexpr size_t SMALL_WORDS = 8;      // 512 cells, counts fit 16 bits
+    static constexpr size_t LARGE_WORDS = 512;    // 32768 cells
+
+    FreeCells() = default;
+    // Counts of every cell occupied leaves clear
+    explicit FreeCells(const Bitboard& occupied);
+
+    // Count again from scratch, e.g. after occupied was loaded from elsewhere
+    void rebuild(const Bitboard& occupied);
+
+    // Call right after occupied.set(x, y) / occupied.reset(x, y)
+    inline void take(int x, int y)
+    {
+        const size_t word = (size_t)y * wordsPerRow + (x >> 6);
+        small[word / SMALL_WORDS]--;
+        large[word / LARGE_WORDS]--;
+        count--;
+    }
+    inline void release(int x, int y)
+    {
+        const size_t word = (size_t)y * wordsPerRow + (x >> 6);
+        small[word / SMALL_WORDS]++;
+        large[word / LARGE_WORDS]++;
+        count++;
+    }
+
+    inline size_t size() const { return count; }
+    inline bool empty() const { return count == 0; }
+    inline size_t bytes() const { return small.bytes() + large.bytes(); }
+
+    // Uniformly random free cell as y * width + x, the set must not be empty
+    inline uint32_t sample(const Bitboard& occupied, SnakeRng& rng) const
+    {
+        return select(occupied, rng.nextBelow(count));
+    }
+    // The k-th free cell in cell order, k < size()
+    uint32_t select(const Bitboard& occupied, uint64_t k) const;
+
+    // Raw copy of the counts to/from stateBytes() bytes
+    inline size_t stateBytes() const { return bytes() + sizeof(uint64_t); }
+    void save(void* out) const;
+    void load(const void* in);
+
+private:
+    int width = 0;
+    int wordsPerRow = 0;
+    uint64_t lastWordMask = 0;          // Cells in the last word of a row
+    AlignedBuffer<uint16_t> small;      // Free cells per SMALL_WORDS words
+    AlignedBuffer<uint32_t> large;      // Free cells per LARGE_WORDS words
+    size_t count = 0;
+
+    // Clear bits of a word that are cells of the board
+    inline uint64_t freeBits(const Bitboard& occupied, size_t word) const
+    {
+        const uint64_t mask = word % wordsPerRow == (size_t)wordsPerRow - 1 ? lastWordMask : ~0ull;
+        return ~occupied.row(0)[word] & mask;
+    }
+};
+
+#endif
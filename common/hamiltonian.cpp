@@ -0,0 +1,137 @@
+#include "hamiltonian.hpp"
+
+// Class definitions
+// ----------------------------------------------------------
+HamiltonianPilot::HamiltonianPilot(const GameConfig& config)
+    : width(config.width), height(config.height), wrap(!config.walls), growth(config.growth)
+{
+    build();
+}
+
+void HamiltonianPilot::build()
+{
+    const bool transpose = height % 2 != 0 && width % 2 == 0;
+    const bool spliced = height % 2 != 0 && width % 2 != 0;
+    valid = width >= 2 && height >= 2 && (!spliced || (wrap && width >= 3 && height >= 3));
+    if (!valid) return;
+
+    index.resize((size_t)width * height);
+    next.resize((size_t)width * height);
+
+    // Cells are emitted in cycle order, each one sets the direction of the one before
+    uint32_t position = 0;
+    int firstX = 0, firstY = 0, lastX = 0, lastY = 0;
+    auto link = [&](int fromX, int fromY, int toX, int toY) {
+        int dx = toX - fromX, dy = toY - fromY;
+        INPUT_TYPE direction;
+        // A step of more than one cell is the wrap edge (boards narrower than 3 never use it)
+        if (dx == 1 || (dx == 1 - width && width > 2)) direction = RIGHT;
+        else if (dx != 0) direction = LEFT;
+        else if (dy == 1 || (dy == 1 - height && height > 2)) direction = DOWN;
+        else direction = UP;
+        next[(size_t)fromY * width + fromX] = (uint8_t)direction;
+    };
+    auto emit = [&](int x, int y) {
+        if (position > 0) link(lastX, lastY, x, y);
+        else {
+            firstX = x;
+            firstY = y;
+        }
+        index[(size_t)y * width + x] = position++;
+        lastX = x;
+        lastY = y;
+    };
+
+    // Serpentine over `rows` rows of `columns` cells (rows even): row 0 left
+    // to right, the others back and forth over columns 1.., column 0 back up.
+    // With transpose, rows are columns.
+    const int columns = transpose ? height : width;
+    const int rows = transpose ? width : (spliced ? height - 1 : height);
+    auto cell = [&](int c, int r) {
+        if (transpose) emit(r, c);
+        else emit(c, r);
+    };
+    for (int c = 0; c < columns; c++) cell(c, 0);
+    for (int r = 1; r < rows; r++) {
+        if (r % 2 == 1) {
+            for (int c = columns - 1; c >= 1; c--) {
+                cell(c, r);
+                // Both sides odd: the last row of the torus goes in between
+                // (2, rows - 1) and (1, rows - 1), once around through its wrap edge
+                if (spliced && r == rows - 1 && c == 2) {
+                    for (int x = 2; x < width; x++) emit(x, height - 1);
+                    emit(0, height - 1);
+                    emit(1, height - 1);
+                }
+            }
+        }
+        else {
+            for (int c = 1; c < columns; c++) cell(c, r);
+        }
+    }
+    for (int r = rows - 1; r >= 1; r--) cell(0, r);
+    link(lastX, lastY, firstX, firstY);
+}
+
+bool HamiltonianPilot::neighbour(int& x, int& y, int direction) const
+{
+    switch (direction) {
+    case UP: y--; break;
+    case DOWN: y++; break;
+    case LEFT: x--; break;
+    default: x++; break;
+    }
+    if (x >= 0 && y >= 0 && x < width && y < height) return true;
+    if (!wrap) return false;
+    x = (x + width) % width;
+    y = (y + height) % height;
+    return true;
+}
+
+INPUT_TYPE HamiltonianPilot::decide(const Bitboard& occupied, int headX, int headY, int tailX, int tailY, int foodX, int foodY,
+    INPUT_TYPE dir, int length, int growPending)
+{
+    if (!valid || foodX < 0) return dir;
+
+    const uint32_t cells = (uint32_t)width * height;
+    const uint32_t head = cycleIndex(headX, headY);
+    // The body lies on the cycle from the tail to the head, the cells from the
+    // head forward to the tail are free. A one-cell snake has the board ahead.
+    const uint32_t toTail = length > 1 ? distance(head, cycleIndex(tailX, tailY)) : cells;
+    const uint32_t toFood = distance(head, cycleIndex(foodX, foodY));
+
+    // Longest jump forward, only while the snake and its pending growth fill
+    // at most a quarter of the board. The cells jumped over stay free behind the
+    // head until the tail passes them, so the free cells left ahead must
+    // outnumber all free cells behind by growPending + growth + 2.
+    uint32_t allowed = 1;
+    const int64_t freeCells = (int64_t)cells - length;
+    const int64_t room = (int64_t)toTail - 1 - (freeCells + growPending + growth + 3) / 2;
+    if ((length + growPending + growth) * 4 <= (int64_t)cells && room > 1) allowed = (uint32_t)room;
+    // Never jump past the food when it is ahead
+    if (toFood < toTail && toFood < allowed) allowed = toFood;
+
+    const INPUT_TYPE follow = cycleDirection(headX, headY);
+    INPUT_TYPE best = follow, nearest = dir;
+    uint32_t bestJump = (follow ^ 1) == dir ? 0 : 1, nearestJump = UINT32_MAX;
+    for (int d = 0; d < 4; d++) {
+        if ((d ^ 1) == dir || d == follow) continue;
+        int x = headX, y = headY;
+        if (!neighbour(x, y, d) || occupied.test(x, y)) continue;
+        uint32_t jump = distance(head, cycleIndex(x, y));
+        if (jump > bestJump && jump <= allowed) {
+            bestJump = jump;
+            best = (INPUT_TYPE)d;
+        }
+        if (jump < nearestJump && jump < toTail) {
+            nearestJump = jump;
+            nearest = (INPUT_TYPE)d;
+        }
+    }
+    // The next cycle cell is straight behind a one-cell snake, which the game
+    // does not allow: step to the closest cell ahead instead
+    if (bestJump == 0) best = nearest;
+    if (best != follow) shortcuts++;
+    return best;
+}
+// ----------------------------------------------------------
@@ -0,0 +1,66 @@
+#ifndef HAMILTONIAN_HPP
+#define HAMILTONIAN_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "bitboard.hpp"
+#include "snakerules.hpp"
+
+// Autopilot that fills the board: it follows a Hamiltonian cycle through
+// every cell, so the body always lies along the cycle behind the head and the
+// tail is always ahead of it. While the snake fills at most a quarter of the
+// board it cuts across the cycle toward the food, as long as the jump lands
+// before the tail with enough free cells left to absorb the growth.
+//
+// Cycles: an even number of rows (or columns) gets the usual serpentine with
+// a return column. Both sides odd has no cycle with walls, on a torus the
+// last row is spliced into the serpentine of the others through its wrap edge.
+class HamiltonianPilot
+{
+public:
+    explicit HamiltonianPilot(const GameConfig& config);
+
+    // false if the board has no Hamiltonian cycle (both sides odd with walls,
+    // or a side shorter than 2); decide() then just keeps the direction
+    inline bool isValid() const { return valid; }
+    inline int getWidth() const { return width; }
+    inline int getHeight() const { return height; }
+
+    // Position of a cell on the cycle, and the direction to the next cell
+    inline uint32_t cycleIndex(int x, int y) const { return index[(size_t)y * width + x]; }
+    inline INPUT_TYPE cycleDirection(int x, int y) const { return (INPUT_TYPE)next[(size_t)y * width + x]; }
+
+    // Action for the next tick: game.handleInput(pilot.decide(game))
+    template <typename Game>
+    INPUT_TYPE decide(const Game& game)
+    {
+        return decide(game.getOccupancy(), game.getHead().x, game.getHead().y, game.getTailTip().x, game.getTailTip().y,
+            game.getFood().x, game.getFood().y, game.getDir(), game.getLength(), game.getState().growPending);
+    }
+    INPUT_TYPE decide(const Bitboard& occupied, int headX, int headY, int tailX, int tailY, int foodX, int foodY,
+        INPUT_TYPE dir, int length, int growPending);
+
+    // Ticks that took a shortcut instead of the next cycle cell
+    inline uint64_t getShortcuts() const { return shortcuts; }
+
+private:
+    int width, height;
+    bool wrap;
+    int growth;
+    bool valid = false;
+    std::vector<uint32_t> index;    // Cycle position per cell
+    std::vector<uint8_t> next;      // INPUT_TYPE to the next cell on the cycle
+    uint64_t shortcuts = 0;
+
+    // Cycle positions from a to b going forward
+    inline uint32_t distance(uint32_t a, uint32_t b) const
+    {
+        uint32_t cells = (uint32_t)width * height;
+        return b >= a ? b - a : b + cells - a;
+    }
+    bool neighbour(int& x, int& y, int direction) const;
+    void build();
+};
+
+#endif
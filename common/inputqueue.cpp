@@ -0,0 +1,15 @@
+#include "inputqueue.hpp"
+
+// Class definitions
+// ----------------------------------------------------------
+INPUT_TYPE InputQueue::nextTurn(INPUT_TYPE current, Clock::time_point tick)
+{
+    Press press;
+    while (presses.pop(press)) {
+        if (press.direction == current || (press.direction ^ 1) == current) continue;
+        latency.add(std::chrono::duration<double, std::micro>(tick - press.time).count());
+        return press.direction;
+    }
+    return current;
+}
+// ----------------------------------------------------------
@@ -0,0 +1,46 @@
+#ifndef INPUTQUEUE_HPP
+#define INPUTQUEUE_HPP
+
+#include <chrono>
+#include <cstddef>
+
+#include "boundedqueue.hpp"
+#include "snakerules.hpp"
+#include "tickclock.hpp"
+
+// Key presses in the order they happened, stamped when they arrive (from the
+// GLFW key callback), so a tap between two ticks is not lost. The game takes
+// at most one turn per tick: two quick presses turn on two consecutive ticks.
+class InputQueue
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    explicit InputQueue(size_t capacity = 16) : presses(capacity), latency(1000000) {}
+
+    // Any thread; false if the queue is full and the press was dropped
+    inline bool push(INPUT_TYPE direction, Clock::time_point time = Clock::now())
+    {
+        return presses.push(Press{ direction, time });
+    }
+
+    // Once per tick, on the thread that steps the game: the oldest press that
+    // turns the snake, or current if there is none. Presses that would not turn
+    // it (the same direction, or straight back) are dropped on the way.
+    INPUT_TYPE nextTurn(INPUT_TYPE current, Clock::time_point tick = Clock::now());
+
+    // Time from a press to the tick that took the turn, in microseconds
+    inline const TimingHistogram& getLatency() const { return latency; }
+
+private:
+    struct Press
+    {
+        INPUT_TYPE direction;
+        Clock::time_point time;
+    };
+
+    BoundedQueue<Press> presses;
+    TimingHistogram latency;
+};
+
+#endif
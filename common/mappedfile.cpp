@@ -0,0 +1,69 @@
+#include "mappedfile.hpp"
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const char* path)
+{
+    close();
+
+#if defined(_WIN32)
+    HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(handle, &fileSize);
+    size = (size_t)fileSize.QuadPart;
+    HANDLE view = size > 0 ? CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    if (!view) {
+        CloseHandle(handle);
+        size = 0;
+        return false;
+    }
+    fileHandle = handle;
+    mapping = view;
+    data = (const uint8_t*)MapViewOfFile(view, FILE_MAP_READ, 0, 0, 0);
+#else
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    size = (size_t)info.st_size;
+    void* memory = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    data = memory == MAP_FAILED ? nullptr : (const uint8_t*)memory;
+#endif
+    if (!data) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::close()
+{
+#if defined(_WIN32)
+    if (data) UnmapViewOfFile(data);
+    if (mapping) CloseHandle(mapping);
+    if (fileHandle) CloseHandle(fileHandle);
+    mapping = fileHandle = nullptr;
+#else
+    if (data) munmap((void*)data, size);
+#endif
+    data = nullptr;
+    size = 0;
+}
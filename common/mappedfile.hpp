@@ -0,0 +1,35 @@
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Whole file mapped read-only into memory: opening costs the same for any
+// size, pages are read in on first access.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // false if the file does not exist, is empty or can not be mapped
+    bool open(const char* path);
+    void close();
+
+    inline bool isOpen() const { return data != nullptr; }
+    inline const uint8_t* getData() const { return data; }
+    inline size_t getSize() const { return size; }
+
+private:
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+#if defined(_WIN32)
+    void* fileHandle = nullptr;
+    void* mapping = nullptr;
+#endif
+};
+
+#endif
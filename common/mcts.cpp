@@ -0,0 +1,328 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+#include "mcts.hpp"
+
+// Helpers
+// ----------------------------------------------------------
+// Rollout policy: a random move that does not hit the body or a wall right
+// away, half of the time the one that gets closer to the food
+static INPUT_TYPE rolloutAction(const SnakeGL& game, SnakeRng& rng, bool walls)
+{
+    const int headX = game.getHead().x, headY = game.getHead().y;
+    const int width = game.getWidth(), height = game.getHeight();
+    INPUT_TYPE safe[4];
+    int count = 0;
+    for (int d = 0; d < 4; d++) {
+        if ((d ^ 1) == game.getDir()) continue;
+        int x = headX, y = headY;
+        if (walls && ((d == UP && y == 0) || (d == DOWN && y == height - 1) || (d == LEFT && x == 0) || (d == RIGHT && x == width - 1))) continue;
+        game.moveCell(x, y, (INPUT_TYPE)d);
+        if (!game.isSnake(x, y)) safe[count++] = (INPUT_TYPE)d;
+    }
+    if (count == 0) return game.getDir();
+
+    uint64_t r = rng.next();
+    if ((r & 1) && game.getFood().x >= 0) {
+        int dx = game.getFood().x - headX, dy = game.getFood().y - headY;
+        if (!walls) {
+            if (dx > width / 2) dx -= width;
+            else if (dx < -width / 2) dx += width;
+            if (dy > height / 2) dy -= height;
+            else if (dy < -height / 2) dy += height;
+        }
+        for (int i = 0; i < count; i++) {
+            INPUT_TYPE d = safe[i];
+            if ((d == RIGHT && dx > 0) || (d == LEFT && dx < 0) || (d == DOWN && dy > 0) || (d == UP && dy < 0)) return d;
+        }
+    }
+    return safe[(r >> 1) % count];
+}
+// ----------------------------------------------------------
+
+// Class definitions
+// ----------------------------------------------------------
+struct MctsPlanner::Worker
+{
+    SnakeGL game;
+    SnakeRng rng;
+    std::vector<uint32_t> path;
+
+    Worker(const GameConfig& config, uint64_t seed, uint64_t stream) : game(config, SnakeRng()), rng(seed, stream) {}
+};
+
+MctsPlanner::MctsPlanner(const GameConfig& _game, const MctsConfig& _config)
+    : game(_game), config(_config)
+{
+    numThreads = config.threads > 0 ? config.threads : std::max(1, (int)std::thread::hardware_concurrency());
+    const int numTrees = config.mode == MCTS_ROOT_PARALLEL ? numThreads : 1;
+    for (int t = 0; t < numTrees; t++) {
+        trees.emplace_back(new Tree());
+        trees.back()->nodes.reset(new Node[config.poolNodes]);
+        trees.back()->spare.reset(new Node[config.poolNodes]);
+        trees.back()->copyQueue.reserve(config.poolNodes);
+        clearTree(*trees.back());
+    }
+    for (int w = 0; w < numThreads; w++) {
+        workers.emplace_back(new Worker(game, config.seed, (uint64_t)w));
+    }
+}
+
+MctsPlanner::~MctsPlanner() = default;
+
+void MctsPlanner::reset()
+{
+    for (auto& tree : trees) clearTree(*tree);
+    hasLast = false;
+}
+
+size_t MctsPlanner::getTreeNodes() const
+{
+    size_t total = 0;
+    for (const auto& tree : trees) total += std::min(tree->used.load(), config.poolNodes) - 1;
+    return total;
+}
+
+void MctsPlanner::initNode(Node& node, bool valid)
+{
+    node.visits.store(0, std::memory_order_relaxed);
+    node.virtualLoss.store(0, std::memory_order_relaxed);
+    node.value.store(0, std::memory_order_relaxed);
+    node.children.store(0, std::memory_order_relaxed);
+    node.state.store(NODE_LEAF, std::memory_order_relaxed);
+    node.valid = valid;
+}
+
+void MctsPlanner::clearTree(Tree& tree)
+{
+    // Node 0 stands for "no children"
+    tree.used.store(1, std::memory_order_relaxed);
+    tree.root = allocate(tree, 1);
+    initNode(tree.nodes[tree.root], true);
+}
+
+uint32_t MctsPlanner::allocate(Tree& tree, uint32_t count)
+{
+    uint32_t first = tree.used.load(std::memory_order_relaxed);
+    do {
+        if (first + count > config.poolNodes) return 0;
+    } while (!tree.used.compare_exchange_weak(first, first + count, std::memory_order_relaxed));
+    return first;
+}
+
+bool MctsPlanner::advance(Tree& tree, INPUT_TYPE action)
+{
+    const Node& root = tree.nodes[tree.root];
+    if (root.state.load(std::memory_order_relaxed) != NODE_EXPANDED) return false;
+    const uint32_t child = root.children.load(std::memory_order_relaxed) + action;
+    if (!tree.nodes[child].valid) return false;
+
+    // Copy the subtree breadth first into the spare pool, children stay in groups of 4
+    Node* from = tree.nodes.get();
+    Node* to = tree.spare.get();
+    // Spare node i + 1 is a copy of from[queue[i]], node 0 stays unused
+    std::vector<uint32_t>& queue = tree.copyQueue;
+    queue.clear();
+    queue.push_back(child);
+    uint32_t used = 2;
+    for (size_t i = 0; i < queue.size(); i++) {
+        const Node& source = from[queue[i]];
+        Node& target = to[i + 1];
+        initNode(target, source.valid != 0);
+        target.visits.store(source.visits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        target.value.store(source.value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        if (source.state.load(std::memory_order_relaxed) != NODE_EXPANDED) continue;
+
+        const uint32_t children = source.children.load(std::memory_order_relaxed);
+        target.children.store(used, std::memory_order_relaxed);
+        target.state.store(NODE_EXPANDED, std::memory_order_relaxed);
+        used += 4;
+        for (uint32_t d = 0; d < 4; d++) queue.push_back(children + d);
+    }
+
+    std::swap(tree.nodes, tree.spare);
+    tree.used.store(used, std::memory_order_relaxed);
+    tree.root = 1;
+    reusedNodes += used - 2;
+    return true;
+}
+
+uint32_t MctsPlanner::selectChild(const Tree& tree, uint32_t node, SnakeRng& rng) const
+{
+    const Node& parent = tree.nodes[node];
+    const uint32_t first = parent.children.load(std::memory_order_acquire);
+    const double parentVisits = parent.visits.load(std::memory_order_relaxed) + parent.virtualLoss.load(std::memory_order_relaxed);
+    const double logParent = std::log(std::max(1.0, parentVisits));
+
+    uint32_t best = first;
+    double bestScore = -1;
+    for (uint32_t d = 0; d < 4; d++) {
+        const Node& child = tree.nodes[first + d];
+        if (!child.valid) continue;
+        // A virtual loss counts as a visit that earned nothing
+        const int visits = child.visits.load(std::memory_order_relaxed) + child.virtualLoss.load(std::memory_order_relaxed);
+        double score;
+        if (visits == 0) {
+            // Unvisited children first, in random order
+            score = 1e9 + (double)(rng.next() >> 40);
+        }
+        else {
+            double mean = (double)child.value.load(std::memory_order_relaxed) / VALUE_ONE / visits;
+            score = mean + config.exploration * std::sqrt(logParent / visits);
+        }
+        if (score > bestScore) {
+            bestScore = score;
+            best = first + d;
+        }
+    }
+    return best;
+}
+
+void MctsPlanner::expand(Tree& tree, uint32_t node, INPUT_TYPE direction)
+{
+    Node& parent = tree.nodes[node];
+    uint8_t expected = NODE_LEAF;
+    // Whoever loses the race just plays out from the leaf
+    if (!parent.state.compare_exchange_strong(expected, NODE_EXPANDING, std::memory_order_acq_rel)) return;
+
+    const uint32_t first = allocate(tree, 4);
+    if (first == 0) {
+        // Pool full, the node stays a leaf
+        parent.state.store(NODE_LEAF, std::memory_order_release);
+        return;
+    }
+    for (int d = 0; d < 4; d++) initNode(tree.nodes[first + d], (d ^ 1) != direction);
+    parent.children.store(first, std::memory_order_release);
+    parent.state.store(NODE_EXPANDED, std::memory_order_release);
+}
+
+void MctsPlanner::playout(Tree& tree, Worker& worker)
+{
+    SnakeGL& sim = worker.game;
+    sim.restore(rootSnapshot.data());
+    sim.setRng(SnakeRng(worker.rng.next()));
+    worker.path.clear();
+
+    uint32_t node = tree.root;
+    worker.path.push_back(node);
+    int ticks = 0;
+    double food = 0;
+
+    // Down the tree
+    while (!sim.isGameOver()) {
+        Node& current = tree.nodes[node];
+        uint8_t state = current.state.load(std::memory_order_acquire);
+        if (state == NODE_LEAF && current.visits.load(std::memory_order_relaxed) >= config.expandVisits) {
+            expand(tree, node, sim.getDir());
+            state = current.state.load(std::memory_order_acquire);
+        }
+        if (state != NODE_EXPANDED) break;
+
+        uint32_t child = selectChild(tree, node, worker.rng);
+        tree.nodes[child].virtualLoss.fetch_add(1, std::memory_order_relaxed);
+        worker.path.push_back(child);
+        ticks++;
+        if (sim.step((INPUT_TYPE)(child - current.children.load(std::memory_order_relaxed))).status == ATE_FOOD) {
+            food += std::pow(0.98, ticks);
+        }
+        node = child;
+    }
+
+    // Random rollout
+    for (int i = 0; i < config.rolloutTicks && !sim.isGameOver(); i++) {
+        ticks++;
+        if (sim.step(rolloutAction(sim, worker.rng, game.walls)).status == ATE_FOOD) food += std::pow(0.98, ticks);
+    }
+
+    // Half for staying alive (dying late is better than dying early), half for food soon
+    double survival = sim.isGameOver() ? (double)ticks / (ticks + config.rolloutTicks) : 1.0;
+    double reward = 0.5 * survival + 0.5 * std::min(1.0, food);
+    int64_t value = (int64_t)(reward * VALUE_ONE);
+
+    for (size_t i = 0; i < worker.path.size(); i++) {
+        Node& visited = tree.nodes[worker.path[i]];
+        visited.visits.fetch_add(1, std::memory_order_relaxed);
+        visited.value.fetch_add(value, std::memory_order_relaxed);
+        if (i > 0) visited.virtualLoss.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+INPUT_TYPE MctsPlanner::bestAction(const SnakeGL& position) const
+{
+    int64_t visits[4] = {};
+    bool any = false;
+    for (const auto& tree : trees) {
+        const Node& root = tree->nodes[tree->root];
+        if (root.state.load(std::memory_order_acquire) != NODE_EXPANDED) continue;
+        const uint32_t first = root.children.load(std::memory_order_relaxed);
+        for (int d = 0; d < 4; d++) {
+            if (!tree->nodes[first + d].valid) continue;
+            visits[d] += tree->nodes[first + d].visits.load(std::memory_order_relaxed);
+            any = true;
+        }
+    }
+    if (!any) {
+        // Too little time to grow a tree
+        SnakeRng rng(config.seed);
+        return rolloutAction(position, rng, game.walls);
+    }
+    int best = -1;
+    for (int d = 0; d < 4; d++) {
+        if ((d ^ 1) == position.getDir()) continue;
+        if (best < 0 || visits[d] > visits[best]) best = d;
+    }
+    return (INPUT_TYPE)best;
+}
+
+INPUT_TYPE MctsPlanner::decide(const SnakeGL& position)
+{
+    auto start = std::chrono::steady_clock::now();
+    const double budgetMs = config.tickFraction > 0 ? config.tickFraction * position.getTickDuration() : config.budgetMs;
+    const auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double, std::milli>(budgetMs));
+
+    // Keep the subtree if the game went where the last decision expected
+    reused = hasLast && !position.isGameOver() && position.getHead().x == expectX && position.getHead().y == expectY &&
+        position.getScore() >= expectScore;
+    reusedNodes = 0;
+    for (auto& tree : trees) {
+        if (!reused || !advance(*tree, lastAction)) clearTree(*tree);
+    }
+
+    rootSnapshot.resize(position.snapshotBytes());
+    position.snapshot(rootSnapshot.data());
+
+    std::atomic<uint64_t> total{ 0 };
+    auto run = [&](int w) {
+        Tree& tree = *trees[config.mode == MCTS_ROOT_PARALLEL ? w : 0];
+        Worker& worker = *workers[w];
+        for (uint64_t n = 0;; n++) {
+            // The clock is read every few playouts only
+            if ((n & 7) == 0 && std::chrono::steady_clock::now() >= deadline) break;
+            if (config.maxPlayouts && total.fetch_add(1, std::memory_order_relaxed) >= config.maxPlayouts) break;
+            playout(tree, worker);
+            if (!config.maxPlayouts) total.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+    if (!position.isGameOver()) {
+        std::vector<std::thread> threads;
+        for (int w = 1; w < numThreads; w++) threads.emplace_back(run, w);
+        run(0);
+        for (std::thread& thread : threads) thread.join();
+    }
+    playouts = std::min(total.load(), config.maxPlayouts ? config.maxPlayouts : UINT64_MAX);
+
+    INPUT_TYPE action = bestAction(position);
+    hasLast = true;
+    lastAction = action;
+    expectX = position.getHead().x;
+    expectY = position.getHead().y;
+    expectScore = position.getScore();
+    position.moveCell(expectX, expectY, (action ^ 1) == position.getDir() ? position.getDir() : action);
+
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return action;
+}
+// ----------------------------------------------------------
@@ -0,0 +1,128 @@
+#ifndef MCTS_HPP
+#define MCTS_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "snakegl.hpp"
+
+// Monte Carlo tree search bot. A playout restores the position from a
+// snapshot, walks the tree with UCT, plays a fast random rollout and adds its
+// reward to every node on the way. Food is random to the bot: every playout
+// draws future food from its own stream, so nodes stand for action sequences
+// (open loop) rather than positions.
+//
+// Tree parallel: all threads share one tree; a thread passing through a node
+// adds a virtual loss (a visit with reward 0) so the others spread out. Root
+// parallel: every thread grows its own tree, the root statistics are summed.
+// Nodes come from a preallocated pool, taken with one atomic add, and
+// children are published with a compare-and-swap, so nothing takes a lock.
+// After each decision the subtree of the chosen action is copied to the front
+// of the pool and becomes the next root.
+
+enum MCTS_MODE
+{
+    MCTS_TREE_PARALLEL,
+    MCTS_ROOT_PARALLEL
+};
+
+struct MctsConfig
+{
+    MCTS_MODE mode = MCTS_TREE_PARALLEL;
+    int threads = 0;            // 0: one per hardware thread
+    double budgetMs = 50;       // Search time per decision
+    double tickFraction = 0;    // If > 0, the budget is this share of the game's tick duration instead
+    uint64_t maxPlayouts = 0;   // Stop earlier after this many playouts, 0 for time only
+    int rolloutTicks = 40;      // Random moves after leaving the tree
+    int expandVisits = 4;       // Visits before a leaf gets children
+    double exploration = 0.5;   // UCT constant, rewards are in [0, 1]
+    uint32_t poolNodes = 1 << 20; // Per tree
+    uint64_t seed = 1;
+};
+
+class MctsPlanner
+{
+public:
+    MctsPlanner(const GameConfig& _game, const MctsConfig& _config = MctsConfig());
+    ~MctsPlanner();
+
+    MctsPlanner(const MctsPlanner&) = delete;
+    MctsPlanner& operator=(const MctsPlanner&) = delete;
+
+    // Search from the current position and return the most visited action.
+    // game must have the GameConfig the planner was built for. Called on the
+    // position after the returned action, the tree below it is kept.
+    INPUT_TYPE decide(const SnakeGL& game);
+
+    // Forget the trees
+    void reset();
+
+    inline int getThreads() const { return numThreads; }
+    // Statistics of the last decide()
+    inline uint64_t getPlayouts() const { return playouts; }
+    inline double getSeconds() const { return seconds; }
+    inline bool wasReused() const { return reused; }
+    inline uint32_t getReusedNodes() const { return reusedNodes; }
+    size_t getTreeNodes() const;
+
+private:
+    enum NODE_STATE : uint8_t
+    {
+        NODE_LEAF,
+        NODE_EXPANDING,
+        NODE_EXPANDED
+    };
+
+    struct Node
+    {
+        std::atomic<int32_t> visits;
+        std::atomic<int32_t> virtualLoss;
+        std::atomic<int64_t> value;     // Sum of rewards, VALUE_ONE per 1.0
+        std::atomic<uint32_t> children; // First of 4 children (one per INPUT_TYPE), 0 for none
+        std::atomic<uint8_t> state;     // NODE_STATE
+        uint8_t valid;                  // false for the move straight back
+    };
+
+    struct Tree
+    {
+        std::unique_ptr<Node[]> nodes, spare;
+        std::vector<uint32_t> copyQueue;    // advance(): source of spare node i + 1, reserved to the pool size
+        std::atomic<uint32_t> used{ 0 };
+        uint32_t root = 0;
+    };
+
+    struct Worker;
+
+    static constexpr int64_t VALUE_ONE = 1 << 20;
+
+    GameConfig game;
+    MctsConfig config;
+    int numThreads;
+    std::vector<std::unique_ptr<Tree>> trees;       // One shared tree, or one per thread
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<uint8_t> rootSnapshot;
+
+    // Where the last decision was expected to take the game
+    bool hasLast = false;
+    INPUT_TYPE lastAction = UP;
+    int expectX = 0, expectY = 0, expectScore = 0;
+
+    uint64_t playouts = 0;
+    double seconds = 0;
+    bool reused = false;
+    uint32_t reusedNodes = 0;
+
+    void clearTree(Tree& tree);
+    uint32_t allocate(Tree& tree, uint32_t count);
+    void initNode(Node& node, bool valid);
+    // Keep only the subtree of action, copied to the start of the pool
+    bool advance(Tree& tree, INPUT_TYPE action);
+    uint32_t selectChild(const Tree& tree, uint32_t node, SnakeRng& rng) const;
+    void expand(Tree& tree, uint32_t node, INPUT_TYPE direction);
+    void playout(Tree& tree, Worker& worker);
+    INPUT_TYPE bestAction(const SnakeGL& position) const;
+};
+
+#endif
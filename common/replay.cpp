@@ -0,0 +1,293 @@
+#include <assert.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "replay.hpp"
+
+// Class definitions
+// ----------------------------------------------------------
+ReplayWriter::ReplayWriter(const char* path, const GameConfig& config, const SnakeRng& rng, uint32_t keyframeInterval)
+    : freeChunks(MAX_CHUNKS), fullChunks(MAX_CHUNKS), freeSnapshots(MAX_KEYFRAMES), fullSnapshots(MAX_KEYFRAMES)
+{
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "SNKR", 4);
+    header.formatVersion = REPLAY_FORMAT_VERSION;
+    header.rulesVersion = RULES_VERSION;
+    header.width = config.width;
+    header.height = config.height;
+    header.walls = config.walls;
+    header.growth = config.growth;
+    header.rngKey = rng.getKey();
+    header.rngCounter = rng.getCounter();
+    header.keyframeInterval = keyframeInterval;
+    nextKeyframe = keyframeInterval;
+
+    // record() works even if the file can not be created, it just drops the ticks
+    takeChunk();
+    file = fopen(path, "wb");
+    if (!file) return;
+    // Placeholder, close() writes the final header over it
+    fwrite(&header, sizeof(header), 1, file);
+    if (keyframeInterval) {
+        keyframes = tmpfile();
+        header.flags |= REPLAY_KEYFRAMES;
+    }
+
+    writer = std::thread([this]() { writeLoop(); });
+}
+
+ReplayWriter::~ReplayWriter()
+{
+    if (file) finish(0, 0, 0);
+}
+
+void ReplayWriter::close(int finalScore, uint64_t finalHash)
+{
+    if (file) finish(REPLAY_FINISHED, finalScore, finalHash);
+}
+
+void ReplayWriter::finish(uint32_t flags, int finalScore, uint64_t finalHash)
+{
+    // Hand over the partial chunk, the writer drains the queue before it stops
+    if (fill > 0) {
+        Filled filled{ currentChunk, (int32_t)((fill + 3) / 4) };
+        while (!fullChunks.push(filled)) std::this_thread::yield();
+    }
+    running.store(false, std::memory_order_release);
+    wakeWriter();
+    writer.join();
+    if (keyframes) appendKeyframes();
+
+    header.flags |= flags;
+    header.ticks = ticks;
+    header.finalScore = finalScore;
+    header.finalHash = finalHash;
+    fseek(file, 0, SEEK_SET);
+    fwrite(&header, sizeof(header), 1, file);
+    fclose(file);
+    file = nullptr;
+}
+
+void ReplayWriter::submit()
+{
+    if (!file) {
+        memset(current, 0, CHUNK_BYTES);
+        fill = 0;
+        return;
+    }
+    Filled filled{ currentChunk, (int32_t)CHUNK_BYTES };
+    while (!fullChunks.push(filled)) std::this_thread::yield();
+    wakeWriter();
+    takeChunk();
+}
+
+void ReplayWriter::takeChunk()
+{
+    int32_t chunk;
+    if (!freeChunks.pop(chunk)) {
+        if (allocated < MAX_CHUNKS) {
+            // The writer fell behind (or this is the first chunk): grow the pool
+            chunk = allocated++;
+            chunks[chunk].reset(new uint8_t[CHUNK_BYTES]());
+        }
+        else {
+            // Every chunk is queued for the disk, nothing left but to wait
+            while (!freeChunks.pop(chunk)) std::this_thread::yield();
+        }
+    }
+    currentChunk = chunk;
+    current = chunks[chunk].get();
+    fill = 0;
+}
+
+uint8_t* ReplayWriter::takeKeyframe(size_t bytes)
+{
+    // Set before the first snapshot is queued and never changed after, so the
+    // writer thread reads it without a race
+    if (snapshotBytes == 0) snapshotBytes = bytes;
+    assert(bytes == snapshotBytes && "keyframes of one replay must have the same size");
+    int32_t snapshot;
+    if (!freeSnapshots.pop(snapshot)) {
+        if (allocatedSnapshots < MAX_KEYFRAMES) {
+            snapshot = allocatedSnapshots++;
+            snapshots[snapshot].reset(new uint8_t[bytes]);
+        }
+        else {
+            while (!freeSnapshots.pop(snapshot)) std::this_thread::yield();
+        }
+    }
+    currentSnapshot = snapshot;
+    return snapshots[snapshot].get();
+}
+
+void ReplayWriter::submitKeyframe()
+{
+    nextKeyframe += header.keyframeInterval;
+    if (!keyframes) {
+        freeSnapshots.push(currentSnapshot);
+        return;
+    }
+    keyframeTicks.push_back(ticks);
+    while (!fullSnapshots.push(currentSnapshot)) std::this_thread::yield();
+    wakeWriter();
+}
+
+void ReplayWriter::wakeWriter()
+{
+    {
+        std::lock_guard<std::mutex> guard(idleLock);
+        pending = true;
+    }
+    idle.notify_one();
+}
+
+void ReplayWriter::appendKeyframes()
+{
+    // Pad the actions to the table offset, then table, entries and snapshots
+    static const uint8_t zeros[8] = {};
+    uint64_t tableOffset = keyframeTableOffset(ticks);
+    fseek(file, 0, SEEK_END);
+    fwrite(zeros, 1, (size_t)(tableOffset - (sizeof(ReplayHeader) + (ticks + 3) / 4)), file);
+
+    KeyframeTable table{ keyframeTicks.size(), snapshotBytes };
+    fwrite(&table, sizeof(table), 1, file);
+    uint64_t offset = tableOffset + sizeof(KeyframeTable) + keyframeTicks.size() * sizeof(KeyframeEntry);
+    for (uint64_t tick : keyframeTicks) {
+        KeyframeEntry entry{ tick, offset };
+        fwrite(&entry, sizeof(entry), 1, file);
+        offset += snapshotBytes;
+    }
+
+    std::unique_ptr<uint8_t[]> buffer(new uint8_t[CHUNK_BYTES]);
+    rewind(keyframes);
+    size_t bytes;
+    while ((bytes = fread(buffer.get(), 1, CHUNK_BYTES, keyframes)) > 0) {
+        fwrite(buffer.get(), 1, bytes, file);
+    }
+    fclose(keyframes);
+    keyframes = nullptr;
+}
+
+void ReplayWriter::writeLoop()
+{
+    for (;;) {
+        // finish() queues its last chunk before clearing running, so once
+        // running is seen cleared empty queues mean everything is written
+        bool stopping = !running.load(std::memory_order_acquire);
+        Filled filled;
+        int32_t snapshot;
+        if (fullChunks.pop(filled)) {
+            uint8_t* chunk = chunks[filled.chunk].get();
+            fwrite(chunk, 1, filled.bytes, file);
+            memset(chunk, 0, CHUNK_BYTES);
+            freeChunks.push(filled.chunk);
+        }
+        else if (fullSnapshots.pop(snapshot)) {
+            fwrite(snapshots[snapshot].get(), 1, snapshotBytes, keyframes);
+            freeSnapshots.push(snapshot);
+        }
+        else if (stopping) {
+            return;
+        }
+        else {
+            // A chunk holds minutes of play: sleep until wakeWriter(). Anything
+            // queued after the pops above set pending first, so it is not missed.
+            std::unique_lock<std::mutex> guard(idleLock);
+            idle.wait(guard, [this]() { return pending; });
+            pending = false;
+        }
+    }
+}
+
+bool ReplayFile::open(const char* path)
+{
+    close();
+    if (!file.open(path) || file.getSize() < sizeof(ReplayHeader)) {
+        close();
+        return false;
+    }
+    const uint8_t* data = file.getData();
+    const size_t size = file.getSize();
+    actions = data + sizeof(ReplayHeader);
+
+    // Replays come from players: check every size before anything is read
+    // through it, and compare by division so huge counts can not wrap around
+    const ReplayHeader& header = getHeader();
+    const uint64_t actionBytes = size - sizeof(ReplayHeader);
+    if (memcmp(header.magic, "SNKR", 4) != 0 || header.formatVersion != REPLAY_FORMAT_VERSION ||
+        header.rulesVersion != (uint32_t)RULES_VERSION ||
+        header.width <= 0 || header.width > REPLAY_MAX_SIDE || header.height <= 0 || header.height > REPLAY_MAX_SIDE ||
+        (uint64_t)header.width * header.height > REPLAY_MAX_CELLS || header.growth < 0 || header.growth > REPLAY_MAX_GROWTH ||
+        header.ticks / 4 > actionBytes || (header.ticks + 3) / 4 > actionBytes) {
+        close();
+        return false;
+    }
+
+    if (header.flags & REPLAY_KEYFRAMES) {
+        uint64_t tableOffset = keyframeTableOffset(header.ticks);
+        if (size < tableOffset || size - tableOffset < sizeof(KeyframeTable)) {
+            close();
+            return false;
+        }
+        table = (const KeyframeTable*)(data + tableOffset);
+        entries = (const KeyframeEntry*)(table + 1);
+        const uint64_t available = size - tableOffset - sizeof(KeyframeTable);
+        const uint64_t snapshotBytes = table->snapshotBytes;
+        if (snapshotBytes > available || table->count > available / (sizeof(KeyframeEntry) + snapshotBytes)) {
+            close();
+            return false;
+        }
+        for (uint64_t i = 0; i < table->count; i++) {
+            if (entries[i].offset > size || size - entries[i].offset < snapshotBytes) {
+                close();
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+long long ReplayFile::findKeyframe(uint64_t tick) const
+{
+    const KeyframeEntry* end = entries + getKeyframeCount();
+    const KeyframeEntry* after = std::upper_bound(entries, end, tick,
+        [](uint64_t value, const KeyframeEntry& entry) { return value < entry.tick; });
+    return (long long)(after - entries) - 1;
+}
+
+void ReplayFile::close()
+{
+    file.close();
+    actions = nullptr;
+    table = nullptr;
+    entries = nullptr;
+}
+
+GameConfig ReplayFile::getConfig() const
+{
+    const ReplayHeader& header = getHeader();
+    GameConfig config;
+    config.width = header.width;
+    config.height = header.height;
+    config.walls = header.walls != 0;
+    config.growth = header.growth;
+    return config;
+}
+// ----------------------------------------------------------
+
+// Function definitions
+// ----------------------------------------------------------
+ReplayOutcome playReplay(const ReplayFile& replay)
+{
+    ReplayOutcome outcome{};
+    dispatchSnakeGL(replay.getConfig(), replay.getRng(), [&](auto& game) {
+        playActions(replay, game, 0, replay.getTicks());
+        outcome.ticks = replay.getTicks();
+        outcome.score = game.getScore();
+        outcome.hash = game.getHash();
+        outcome.gameOver = game.isGameOver();
+    });
+    return outcome;
+}
+// ----------------------------------------------------------
@@ -0,0 +1,245 @@
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "boundedqueue.hpp"
+#include "mappedfile.hpp"
+#include "snakegl.hpp"
+#include "snakerng.hpp"
+
+// Replay files: a fixed header followed by the action of every tick, packed
+// 2 bits per tick (4 ticks per byte, lowest bits first). Playing the actions
+// back through handleInput()/updateSnake() of a game built from the header
+// reproduces the game exactly.
+//
+// Optionally, a full snapshot of the game is stored every keyframeInterval
+// ticks, so seeking re-simulates at most keyframeInterval ticks. They follow
+// the actions, starting on the next 8-byte boundary:
+//   KeyframeTable, KeyframeTable::count KeyframeEntry, then the snapshots.
+
+constexpr uint32_t REPLAY_FORMAT_VERSION = 1;
+constexpr uint32_t REPLAY_FINISHED = 1;     // close() stored the final score and hash
+constexpr uint32_t REPLAY_KEYFRAMES = 2;    // A keyframe table follows the actions
+constexpr int32_t REPLAY_MAX_SIDE = 65535;  // Largest width or height ReplayFile accepts
+constexpr uint64_t REPLAY_MAX_CELLS = 8192ull * 8192; // Largest board (width * height) ReplayFile accepts
+constexpr int32_t REPLAY_MAX_GROWTH = 16;   // growPending stays below 2^31 on the largest board
+
+struct ReplayHeader
+{
+    char magic[4];          // "SNKR"
+    uint32_t formatVersion;
+    uint32_t rulesVersion;  // RULES_VERSION of the recording build
+    uint32_t flags;         // REPLAY_FINISHED
+    int32_t width, height;
+    int32_t walls, growth;
+    uint64_t rngKey;        // Food stream the game started from (seed and stream
+    uint64_t rngCounter;    // are folded into SnakeRng's key)
+    uint64_t ticks;
+    int32_t finalScore;     // Claimed by the recorder, valid with REPLAY_FINISHED
+    uint32_t keyframeInterval; // Ticks between keyframes, valid with REPLAY_KEYFRAMES
+    uint64_t finalHash;     // getHash() after the last tick
+};
+static_assert(sizeof(ReplayHeader) == 72, "ReplayHeader is written as is");
+
+// Seek table
+struct KeyframeTable
+{
+    uint64_t count;
+    uint64_t snapshotBytes; // BasicSnakeGL::snapshotBytes() of every keyframe
+};
+
+struct KeyframeEntry
+{
+    uint64_t tick;          // The snapshot is the state after this many ticks
+    uint64_t offset;        // File offset of the snapshot
+};
+
+// File offset of the keyframe table of a replay with `ticks` ticks
+inline uint64_t keyframeTableOffset(uint64_t ticks)
+{
+    return (sizeof(ReplayHeader) + (ticks + 3) / 4 + 7) / 8 * 8;
+}
+
+// Records a game while it is played. record() only packs two bits into the
+// current chunk; full chunks go to a writer thread through a lock-free queue,
+// so the game loop never waits for the disk. The writer sleeps until a chunk
+// or a keyframe is handed over.
+class ReplayWriter
+{
+public:
+    static constexpr size_t CHUNK_BYTES = 64 * 1024;
+    static constexpr size_t CHUNK_TICKS = CHUNK_BYTES * 4;
+
+    // config and rng are the ones the game was constructed with (before its
+    // first food). keyframeInterval 0 stores no keyframes.
+    ReplayWriter(const char* path, const GameConfig& config, const SnakeRng& rng, uint32_t keyframeInterval = 0);
+    // Closes the file without REPLAY_FINISHED if close() was not called
+    ~ReplayWriter();
+
+    ReplayWriter(const ReplayWriter&) = delete;
+    ReplayWriter& operator=(const ReplayWriter&) = delete;
+
+    inline bool isOpen() const { return file != nullptr; }
+    inline uint64_t getTicks() const { return ticks; }
+
+    // The action passed to step() (or handleInput()) for this tick
+    inline void record(INPUT_TYPE action)
+    {
+        current[fill >> 2] |= (uint8_t)(action << ((fill & 3) * 2));
+        ticks++;
+        if (++fill == CHUNK_TICKS) submit();
+    }
+
+    // Call after every step() with keyframes on: every keyframeInterval ticks
+    // the game state is copied and handed to the writer thread
+    template <typename Game>
+    inline void keyframe(const Game& game)
+    {
+        if (ticks == nextKeyframe && header.keyframeInterval) {
+            game.snapshot(takeKeyframe(game.snapshotBytes()));
+            submitKeyframe();
+        }
+    }
+
+    // Flush everything, store the final score and hash, join the writer thread
+    void close(int finalScore, uint64_t finalHash);
+
+private:
+    static constexpr int MAX_CHUNKS = 64;
+    static constexpr int MAX_KEYFRAMES = 16;    // Snapshots in flight to the writer thread
+
+    struct Filled
+    {
+        int32_t chunk;
+        int32_t bytes;
+    };
+
+    FILE* file = nullptr;
+    ReplayHeader header;
+    std::unique_ptr<uint8_t[]> chunks[MAX_CHUNKS];
+    int allocated = 0;
+    BoundedQueue<int32_t> freeChunks;   // Zeroed chunks ready for the game thread
+    BoundedQueue<Filled> fullChunks;    // Chunks waiting for the writer thread
+    int currentChunk = -1;
+    uint8_t* current = nullptr;
+    size_t fill = 0;                    // Ticks in the current chunk
+    uint64_t ticks = 0;
+
+    // Keyframes go to a scratch file and are appended to the replay by close()
+    FILE* keyframes = nullptr;
+    std::unique_ptr<uint8_t[]> snapshots[MAX_KEYFRAMES];
+    size_t snapshotBytes = 0;           // Set by the first keyframe, read by the writer thread
+    int allocatedSnapshots = 0;
+    BoundedQueue<int32_t> freeSnapshots;
+    BoundedQueue<int32_t> fullSnapshots;
+    int currentSnapshot = -1;
+    uint64_t nextKeyframe = 0;
+    std::vector<uint64_t> keyframeTicks;
+
+    std::atomic<bool> running{ true };
+    // The writer thread sleeps here while both queues are empty
+    std::mutex idleLock;
+    std::condition_variable idle;
+    bool pending = false;
+    std::thread writer;
+
+    void submit();
+    void takeChunk();
+    uint8_t* takeKeyframe(size_t bytes);
+    void submitKeyframe();
+    void appendKeyframes();
+    void wakeWriter();
+    void writeLoop();
+    void finish(uint32_t flags, int finalScore, uint64_t finalHash);
+};
+
+// Read-only view of a replay file, memory mapped: opening costs the same for
+// any length, ticks are paged in as playback reaches them.
+class ReplayFile
+{
+public:
+    // false if the file can not be mapped, is not a replay of a known format and
+    // rules version, asks for a board or growth the limits above do not allow, or
+    // any size in it does not fit the file
+    bool open(const char* path);
+    void close();
+
+    inline bool isOpen() const { return file.isOpen(); }
+    inline const ReplayHeader& getHeader() const { return *(const ReplayHeader*)file.getData(); }
+    inline uint64_t getTicks() const { return getHeader().ticks; }
+    inline bool isFinished() const { return (getHeader().flags & REPLAY_FINISHED) != 0; }
+    GameConfig getConfig() const;
+    inline SnakeRng getRng() const { return SnakeRng::fromState(getHeader().rngKey, getHeader().rngCounter); }
+
+    inline INPUT_TYPE getAction(uint64_t tick) const
+    {
+        return (INPUT_TYPE)((actions[tick >> 2] >> ((tick & 3) * 2)) & 3);
+    }
+
+    // Keyframes, sorted by tick. None unless the replay has REPLAY_KEYFRAMES.
+    inline size_t getKeyframeCount() const { return table ? (size_t)table->count : 0; }
+    inline size_t getSnapshotBytes() const { return table ? (size_t)table->snapshotBytes : 0; }
+    inline uint64_t getKeyframeTick(size_t i) const { return entries[i].tick; }
+    inline const void* getKeyframe(size_t i) const { return file.getData() + entries[i].offset; }
+    // Last keyframe at or before tick, -1 if there is none
+    long long findKeyframe(uint64_t tick) const;
+
+private:
+    MappedFile file;
+    const uint8_t* actions = nullptr;
+    const KeyframeTable* table = nullptr;
+    const KeyframeEntry* entries = nullptr;
+};
+
+// Result of playing a replay back
+struct ReplayOutcome
+{
+    uint64_t ticks;     // Ticks simulated
+    int score;
+    uint64_t hash;      // getHash() after the last tick
+    bool gameOver;
+};
+
+// Feed the ticks [begin, end) of a replay into game through handleInput()/updateSnake()
+template <typename Game>
+void playActions(const ReplayFile& replay, Game& game, uint64_t begin, uint64_t end)
+{
+    for (uint64_t t = begin; t < end; t++) {
+        game.handleInput(replay.getAction(t));
+        game.updateSnake();
+    }
+}
+
+// Play a whole replay from the start on the specialized engine for its config
+ReplayOutcome playReplay(const ReplayFile& replay);
+
+// Bring game to the state after `tick` ticks of the replay: restore the last
+// keyframe before it (or start over) and re-simulate the remaining ticks.
+// A keyframe that is not a consistent position is ignored, the seek then
+// starts over from tick 0. game must have the replay's config.
+template <typename Game>
+void seekReplay(const ReplayFile& replay, Game& game, uint64_t tick)
+{
+    if (tick > replay.getTicks()) tick = replay.getTicks();
+    long long keyframe = replay.findKeyframe(tick);
+    uint64_t from = 0;
+    if (keyframe >= 0 && replay.getSnapshotBytes() == game.snapshotBytes()
+        && game.restoreChecked(replay.getKeyframe((size_t)keyframe))) {
+        from = replay.getKeyframeTick((size_t)keyframe);
+    }
+    else {
+        game = Game(replay.getConfig(), replay.getRng());
+    }
+    playActions(replay, game, from, tick);
+}
+
+#endif
@@ -0,0 +1,376 @@
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+#include <stdexcept>
+
+#include "snakebatch.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SNAKEBATCH_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(SNAKEBATCH_X86) && (defined(__GNUC__) || defined(__clang__))
+#define SNAKEBATCH_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SNAKEBATCH_TARGET_AVX2
+#endif
+
+// Helpers
+// ----------------------------------------------------------
+static bool cpuHasAVX2()
+{
+#if defined(SNAKEBATCH_X86) && (defined(__GNUC__) || defined(__clang__))
+    return __builtin_cpu_supports("avx2");
+#elif defined(SNAKEBATCH_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+
+// Cells per board, the 16 bit cell indices of ring cap it at 65536
+static int boardCells(int width, int height)
+{
+    if (width <= 0 || height <= 0 || (int64_t)width * height > 65536) {
+        throw std::invalid_argument("SnakeBatch boards hold at most 65536 cells");
+    }
+    return width * height;
+}
+// ----------------------------------------------------------
+
+// Class definitions
+// ----------------------------------------------------------
+SnakeBatch::SnakeBatch(int _numGames, int _width, int _height, uint64_t seed, uint64_t firstStream)
+    : numGames(_numGames), width(_width), height(_height), cells(boardCells(_width, _height)),
+    wordsPerGame((_width * _height + 31) / 32),
+    blocksPerGame(((_width * _height + 31) / 32 + BLOCK_WORDS - 1) / BLOCK_WORDS), kernel(bestKernel()),
+    headX(_numGames), headY(_numGames), dir(_numGames),
+    foodX(_numGames), foodY(_numGames),
+    score(_numGames), finalScore(_numGames),
+    length(_numGames), front(_numGames), grow(_numGames), freeCount(_numGames),
+    rng(_numGames), status(_numGames, MOVED),
+    ring((size_t)_numGames * _width * _height),
+    occupancy((size_t)_numGames * ((_width * _height + 31) / 32)),
+    freeBlock((size_t)_numGames * (((_width * _height + 31) / 32 + BLOCK_WORDS - 1) / BLOCK_WORDS)),
+    nextX(_numGames), nextY(_numGames), hit(_numGames), ate(_numGames)
+{
+    for (int game = 0; game < numGames; game++) {
+        rng[game] = SnakeRng(seed, firstStream + game);
+        reset(game);
+    }
+}
+
+SnakeBatch::KERNEL SnakeBatch::bestKernel()
+{
+#ifdef SNAKEBATCH_X86
+    return cpuHasAVX2() ? KERNEL_AVX2 : KERNEL_SSE2;
+#else
+    return KERNEL_SCALAR;
+#endif
+}
+
+bool SnakeBatch::setKernel(KERNEL _kernel)
+{
+#ifdef SNAKEBATCH_X86
+    if (_kernel == KERNEL_AVX2 && !cpuHasAVX2()) return false;
+#else
+    if (_kernel != KERNEL_SCALAR) return false;
+#endif
+    kernel = _kernel;
+    return true;
+}
+
+void SnakeBatch::reset(int game)
+{
+    uint32_t* words = &occupancy[(size_t)game * wordsPerGame];
+    std::fill(words, words + wordsPerGame, 0);
+
+    uint16_t* blocks = &freeBlock[(size_t)game * blocksPerGame];
+    for (int block = 0; block < blocksPerGame; block++) {
+        blocks[block] = (uint16_t)std::min(BLOCK_WORDS * 32, cells - block * BLOCK_WORDS * 32);
+    }
+    freeCount[game] = cells;
+
+    headX[game] = width / 2;
+    headY[game] = height / 2;
+    dir[game] = UP;
+    score[game] = 0;
+    grow[game] = 0;
+    front[game] = 0;
+    length[game] = 1;
+
+    int cell = headY[game] * width + headX[game];
+    ring[(size_t)game * cells] = (uint16_t)cell;
+    enterCell(game, cell);
+
+    spawnFood(game);
+}
+
+void SnakeBatch::spawnFood(int game)
+{
+    // Uniformly on a free cell, like SnakeGL
+    if (freeCount[game] == 0) {
+        foodX[game] = -1;
+        foodY[game] = -1;
+        return;
+    }
+    int k = rng[game].nextInRange(0, freeCount[game] - 1);
+
+    // Block, then word, then bit holding the k-th free cell
+    const uint16_t* blocks = &freeBlock[(size_t)game * blocksPerGame];
+    int block = 0;
+    while (k >= blocks[block]) k -= blocks[block++];
+    const uint32_t* words = &occupancy[(size_t)game * wordsPerGame];
+    int word = block * BLOCK_WORDS;
+    uint32_t free;
+    for (;;) {
+        free = ~words[word];
+        if (word == wordsPerGame - 1 && cells % 32) free &= (1u << (cells % 32)) - 1;
+        const int bits = (int)std::bitset<32>(free).count();
+        if (k < bits) break;
+        k -= bits;
+        word++;
+    }
+    for (; k > 0; k--) free &= free - 1;
+    const int cell = word * 32 + (int)std::bitset<32>((free & (0 - free)) - 1).count();
+    foodX[game] = cell % width;
+    foodY[game] = cell / width;
+}
+
+void SnakeBatch::enterCell(int game, int cell)
+{
+    occupancy[(size_t)game * wordsPerGame + (cell >> 5)] |= 1u << (cell & 31);
+    freeBlock[(size_t)game * blocksPerGame + (cell >> 5) / BLOCK_WORDS]--;
+    freeCount[game]--;
+}
+
+void SnakeBatch::leaveCell(int game, int cell)
+{
+    occupancy[(size_t)game * wordsPerGame + (cell >> 5)] &= ~(1u << (cell & 31));
+    freeBlock[(size_t)game * blocksPerGame + (cell >> 5) / BLOCK_WORDS]++;
+    freeCount[game]++;
+}
+
+int SnakeBatch::getSegment(int game, int i) const
+{
+    int slot = front[game] + i;
+    if (slot >= cells) slot -= cells;
+    return ring[(size_t)game * cells + slot];
+}
+
+bool SnakeBatch::isSnake(int game, int x, int y) const
+{
+    return testCell(game, y * width + x);
+}
+
+void SnakeBatch::step(const uint8_t* actions)
+{
+    switch (kernel)
+    {
+    case KERNEL_AVX2:
+        planAVX2(actions);
+        break;
+    case KERNEL_SSE2:
+        planSSE2(actions);
+        break;
+    default:
+        planScalar(actions, 0);
+        break;
+    }
+    for (int game = 0; game < numGames; game++) {
+        commitGame(game);
+    }
+}
+
+void SnakeBatch::stepGame(int game, uint8_t action)
+{
+    planGame(game, action);
+    commitGame(game);
+}
+
+// Direction, movement and the collision/food tests of one game
+void SnakeBatch::planGame(int game, int action)
+{
+    // Prevent reversing direction: UP^1 == DOWN, LEFT^1 == RIGHT
+    int d = (action ^ 1) == dir[game] ? dir[game] : action;
+    dir[game] = d;
+
+    int x = headX[game] + (d == RIGHT) - (d == LEFT);
+    int y = headY[game] + (d == DOWN) - (d == UP);
+    if (x < 0) x = width - 1;
+    else if (x == width) x = 0;
+    if (y < 0) y = height - 1;
+    else if (y == height) y = 0;
+
+    nextX[game] = x;
+    nextY[game] = y;
+    hit[game] = testCell(game, y * width + x);
+    ate[game] = x == foodX[game] && y == foodY[game];
+}
+
+// Scalar plan for games [begin, numGames), also handles what is left after the vector loops
+void SnakeBatch::planScalar(const uint8_t* actions, int begin)
+{
+    for (int game = begin; game < numGames; game++) {
+        planGame(game, actions[game]);
+    }
+}
+
+#ifdef SNAKEBATCH_X86
+void SnakeBatch::planSSE2(const uint8_t* actions)
+{
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i vUp = _mm_set1_epi32(UP), vDown = _mm_set1_epi32(DOWN);
+    const __m128i vLeft = _mm_set1_epi32(LEFT), vRight = _mm_set1_epi32(RIGHT);
+    const __m128i vWidth = _mm_set1_epi32(width), vHeight = _mm_set1_epi32(height);
+    const __m128i vLastX = _mm_set1_epi32(width - 1), vLastY = _mm_set1_epi32(height - 1);
+    const __m128i minusOne = _mm_set1_epi32(-1);
+
+    int game = 0;
+    for (; game + 4 <= numGames; game += 4) {
+        int32_t packed;
+        memcpy(&packed, actions + game, 4);
+        __m128i action = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), _mm_setzero_si128()), _mm_setzero_si128());
+        __m128i d = _mm_loadu_si128((const __m128i*)&dir[game]);
+
+        // Keep the old direction where the action is its opposite
+        __m128i reverse = _mm_cmpeq_epi32(_mm_xor_si128(action, one), d);
+        d = _mm_or_si128(_mm_and_si128(reverse, d), _mm_andnot_si128(reverse, action));
+        _mm_storeu_si128((__m128i*)&dir[game], d);
+
+        // Compare masks are -1, so "x - (d == RIGHT) + (d == LEFT)" moves one cell
+        __m128i x = _mm_loadu_si128((const __m128i*)&headX[game]);
+        __m128i y = _mm_loadu_si128((const __m128i*)&headY[game]);
+        x = _mm_add_epi32(_mm_sub_epi32(x, _mm_cmpeq_epi32(d, vRight)), _mm_cmpeq_epi32(d, vLeft));
+        y = _mm_add_epi32(_mm_sub_epi32(y, _mm_cmpeq_epi32(d, vDown)), _mm_cmpeq_epi32(d, vUp));
+
+        // Wrap around: -1 -> last column/row, width/height -> 0
+        __m128i under = _mm_cmpeq_epi32(x, minusOne);
+        x = _mm_or_si128(_mm_and_si128(under, vLastX), _mm_andnot_si128(under, x));
+        x = _mm_andnot_si128(_mm_cmpeq_epi32(x, vWidth), x);
+        under = _mm_cmpeq_epi32(y, minusOne);
+        y = _mm_or_si128(_mm_and_si128(under, vLastY), _mm_andnot_si128(under, y));
+        y = _mm_andnot_si128(_mm_cmpeq_epi32(y, vHeight), y);
+
+        _mm_storeu_si128((__m128i*)&nextX[game], x);
+        _mm_storeu_si128((__m128i*)&nextY[game], y);
+
+        __m128i food = _mm_and_si128(
+            _mm_cmpeq_epi32(x, _mm_loadu_si128((const __m128i*)&foodX[game])),
+            _mm_cmpeq_epi32(y, _mm_loadu_si128((const __m128i*)&foodY[game])));
+        _mm_storeu_si128((__m128i*)&ate[game], _mm_and_si128(food, one));
+
+        // SSE2 has no gather, test the occupancy bits one lane at a time
+        for (int lane = 0; lane < 4; lane++) {
+            hit[game + lane] = testCell(game + lane, nextY[game + lane] * width + nextX[game + lane]);
+        }
+    }
+    planScalar(actions, game);
+}
+
+SNAKEBATCH_TARGET_AVX2
+void SnakeBatch::planAVX2(const uint8_t* actions)
+{
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i lowBits = _mm256_set1_epi32(31);
+    const __m256i vUp = _mm256_set1_epi32(UP), vDown = _mm256_set1_epi32(DOWN);
+    const __m256i vLeft = _mm256_set1_epi32(LEFT), vRight = _mm256_set1_epi32(RIGHT);
+    const __m256i vWidth = _mm256_set1_epi32(width), vHeight = _mm256_set1_epi32(height);
+    const __m256i vLastX = _mm256_set1_epi32(width - 1), vLastY = _mm256_set1_epi32(height - 1);
+    const __m256i minusOne = _mm256_set1_epi32(-1);
+    const __m256i laneWords = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(wordsPerGame));
+    const int* words = (const int*)occupancy.data();
+
+    int game = 0;
+    for (; game + 8 <= numGames; game += 8) {
+        __m256i action = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(actions + game)));
+        __m256i d = _mm256_loadu_si256((const __m256i*)&dir[game]);
+
+        // Keep the old direction where the action is its opposite
+        __m256i reverse = _mm256_cmpeq_epi32(_mm256_xor_si256(action, one), d);
+        d = _mm256_blendv_epi8(action, d, reverse);
+        _mm256_storeu_si256((__m256i*)&dir[game], d);
+
+        // Compare masks are -1, so "x - (d == RIGHT) + (d == LEFT)" moves one cell
+        __m256i x = _mm256_loadu_si256((const __m256i*)&headX[game]);
+        __m256i y = _mm256_loadu_si256((const __m256i*)&headY[game]);
+        x = _mm256_add_epi32(_mm256_sub_epi32(x, _mm256_cmpeq_epi32(d, vRight)), _mm256_cmpeq_epi32(d, vLeft));
+        y = _mm256_add_epi32(_mm256_sub_epi32(y, _mm256_cmpeq_epi32(d, vDown)), _mm256_cmpeq_epi32(d, vUp));
+
+        // Wrap around: -1 -> last column/row, width/height -> 0
+        x = _mm256_blendv_epi8(x, vLastX, _mm256_cmpeq_epi32(x, minusOne));
+        x = _mm256_andnot_si256(_mm256_cmpeq_epi32(x, vWidth), x);
+        y = _mm256_blendv_epi8(y, vLastY, _mm256_cmpeq_epi32(y, minusOne));
+        y = _mm256_andnot_si256(_mm256_cmpeq_epi32(y, vHeight), y);
+
+        _mm256_storeu_si256((__m256i*)&nextX[game], x);
+        _mm256_storeu_si256((__m256i*)&nextY[game], y);
+
+        __m256i food = _mm256_and_si256(
+            _mm256_cmpeq_epi32(x, _mm256_loadu_si256((const __m256i*)&foodX[game])),
+            _mm256_cmpeq_epi32(y, _mm256_loadu_si256((const __m256i*)&foodY[game])));
+        _mm256_storeu_si256((__m256i*)&ate[game], _mm256_and_si256(food, one));
+
+        // Gather the occupancy word of every lane's target cell and pick its bit
+        __m256i cell = _mm256_add_epi32(_mm256_mullo_epi32(y, vWidth), x);
+        __m256i index = _mm256_add_epi32(laneWords, _mm256_srli_epi32(cell, 5));
+        __m256i word = _mm256_i32gather_epi32(words + (size_t)game * wordsPerGame, index, 4);
+        __m256i bit = _mm256_and_si256(_mm256_srlv_epi32(word, _mm256_and_si256(cell, lowBits)), one);
+        _mm256_storeu_si256((__m256i*)&hit[game], bit);
+    }
+    planScalar(actions, game);
+}
+#else
+void SnakeBatch::planSSE2(const uint8_t* actions) { planScalar(actions, 0); }
+void SnakeBatch::planAVX2(const uint8_t* actions) { planScalar(actions, 0); }
+#endif
+
+// Scatter the planned move of one game into its body and occupancy memory
+void SnakeBatch::commitGame(int game)
+{
+    if (hit[game]) {
+        status[game] = GAME_OVER;
+        finalScore[game] = score[game];
+        reset(game);
+        return;
+    }
+
+    uint16_t* body = &ring[(size_t)game * cells];
+
+    // The tail tip leaves its cell unless the snake grows
+    if (!grow[game]) {
+        int tip = front[game] + length[game] - 1;
+        if (tip >= cells) tip -= cells;
+        leaveCell(game, body[tip]);
+        length[game]--;
+    }
+
+    int x = nextX[game], y = nextY[game];
+    int cell = y * width + x;
+    front[game] = (front[game] == 0 ? cells : front[game]) - 1;
+    body[front[game]] = (uint16_t)cell;
+    enterCell(game, cell);
+    length[game]++;
+    headX[game] = x;
+    headY[game] = y;
+
+    if (ate[game]) {
+        score[game]++;
+        spawnFood(game);
+        grow[game] = 1;
+        status[game] = ATE_FOOD;
+    }
+    else {
+        grow[game] = 0;
+        status[game] = MOVED;
+    }
+}
+// ----------------------------------------------------------
@@ -0,0 +1,111 @@
+#ifndef SNAKEBATCH_HPP
+#define SNAKEBATCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "snakegl.hpp"
+#include "snakerng.hpp"
+
+// Many independent snake games advanced together, one tick per step() call.
+// Game slot i draws its food from SnakeRng(seed, firstStream + i), exactly like a
+// SnakeGL constructed from that stream, and keeps using it across resets.
+// The per-game state is stored as structure-of-arrays so direction, movement,
+// wrap-around, collision and food tests run as SIMD kernels over all games;
+// only the bookkeeping that scatters into the per-game body/occupancy memory
+// stays scalar. Rules are the ones of SnakeGL::updateSnake, finished games are
+// reset on the spot.
+class SnakeBatch
+{
+public:
+    enum KERNEL
+    {
+        KERNEL_SCALAR,
+        KERNEL_SSE2,
+        KERNEL_AVX2
+    };
+
+    // Boards of up to 65536 cells (e.g. 256x256), cells are stored as 16 bit
+    // indices; larger boards throw std::invalid_argument
+    SnakeBatch(int _numGames, int _width = WIDTH, int _height = HEIGHT, uint64_t seed = 1, uint64_t firstStream = 0);
+
+    // Advance every game by one tick. actions holds one INPUT_TYPE per game.
+    void step(const uint8_t* actions);
+    // Advance a single game by one tick (scalar path)
+    void stepGame(int game, uint8_t action);
+
+    // Start a fresh game in slot `game`
+    void reset(int game);
+
+    // Pick the kernel used by step(), returns false if the CPU can not run it
+    bool setKernel(KERNEL kernel);
+    inline KERNEL getKernel() const { return kernel; }
+    static KERNEL bestKernel();
+
+    inline int getNumGames() const { return numGames; }
+    inline int getWidth() const { return width; }
+    inline int getHeight() const { return height; }
+
+    inline int getHeadX(int game) const { return headX[game]; }
+    inline int getHeadY(int game) const { return headY[game]; }
+    inline int getFoodX(int game) const { return foodX[game]; }
+    inline int getFoodY(int game) const { return foodY[game]; }
+    inline INPUT_TYPE getDir(int game) const { return (INPUT_TYPE)dir[game]; }
+    inline int getScore(int game) const { return score[game]; }
+    // Number of snake cells, head included
+    inline int getLength(int game) const { return length[game]; }
+    // Segment i of a game, 0 is the head
+    int getSegment(int game, int i) const;
+    bool isSnake(int game, int x, int y) const;
+
+    // Outcome of the last step per game (STEP_STATUS). A GAME_OVER game has
+    // already been reset, its final score is in getFinalScores().
+    inline const uint8_t* getStatus() const { return status.data(); }
+    inline const int32_t* getFinalScores() const { return finalScore.data(); }
+
+private:
+    int numGames;
+    int width, height;
+    int cells;          // width * height
+    int wordsPerGame;   // 32 bit occupancy words per game
+    int blocksPerGame;  // Free cell counts per game, one per BLOCK_WORDS words
+    KERNEL kernel;
+
+    // Per-game state
+    std::vector<int32_t> headX, headY, dir;
+    std::vector<int32_t> foodX, foodY;
+    std::vector<int32_t> score, finalScore;
+    std::vector<int32_t> length, front, grow;
+    std::vector<int32_t> freeCount;
+    std::vector<SnakeRng> rng;
+    std::vector<uint8_t> status;
+
+    // Per-game board memory: body ring (head first), occupancy bits and the
+    // free cells per block of occupancy words. Food is the k-th free cell in
+    // cell order, found through the counts like FreeCells does.
+    static constexpr int BLOCK_WORDS = 16;
+    std::vector<uint16_t> ring;
+    std::vector<uint32_t> occupancy;
+    std::vector<uint16_t> freeBlock;
+
+    // Kernel output, one entry per game
+    std::vector<int32_t> nextX, nextY;
+    std::vector<int32_t> hit, ate;
+
+    void planGame(int game, int action);
+    void planScalar(const uint8_t* actions, int begin);
+    void planSSE2(const uint8_t* actions);
+    void planAVX2(const uint8_t* actions);
+    void commitGame(int game);
+    void spawnFood(int game);
+    void enterCell(int game, int cell);
+    void leaveCell(int game, int cell);
+
+    inline bool testCell(int game, int cell) const
+    {
+        return (occupancy[(size_t)game * wordsPerGame + (cell >> 5)] >> (cell & 31)) & 1;
+    }
+};
+
+#endif
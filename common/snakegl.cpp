@@ -0,0 +1,21 @@
+#include <algorithm>
+#include <random>
+
+#include "snakegl.hpp"
+
+uint64_t randomSeed()
+{
+    std::random_device rd;
+    return ((uint64_t)rd() << 32) | rd();
+}
+
+int gameSpeed(int speedValue, int score, int& lastMultipleOfFive) {
+    int decreaseAmount = 0;
+
+    if (score % 5 == 0 && score != lastMultipleOfFive) {
+        lastMultipleOfFive = score;
+        decreaseAmount = 5;
+    }
+
+    return std::max(90, speedValue - decreaseAmount);
+}
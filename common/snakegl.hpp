@@ -0,0 +1,597 @@
+#ifndef SNAKEGL_HPP
+#define SNAKEGL_HPP
+
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <cstring>
+
+#include "alignedbuffer.hpp"
+#include "bitboard.hpp"
+#include "snakerng.hpp"
+#include "freecells.hpp"
+#include "snakerules.hpp"
+#include "snakestate.hpp"
+#include "zobrist.hpp"
+
+// Game rules of SnakeGL, free of any window or OpenGL code so the simulation
+// can run headless (benchmarks, bots, batch runs).
+
+// Class definition
+// ----------------------------------------------------------
+enum STEP_STATUS
+{
+    MOVED,      // Regular move
+    ATE_FOOD,   // The head reached the food, score went up
+    GAME_OVER   // The head ran into the tail (or a wall), the game is finished
+};
+
+// Board cell encoding, one byte per cell. A body cell keeps the direction in
+// which the next segment (toward the head) lies, so the tail tip can follow the
+// body without a separate segment list.
+enum CELL : uint8_t
+{
+    CELL_EMPTY = 0,
+    CELL_HEAD = 1,
+    CELL_BODY = 4   // CELL_BODY | INPUT_TYPE
+};
+
+struct StepResult
+{
+    STEP_STATUS status;
+    int score;
+    bool speedUp; // The score reached a new multiple of five, ticks got shorter
+};
+
+class Entity
+{
+public:
+    int x, y;
+
+    Entity() : x(0), y(0) {}
+    Entity(int _x, int _y) : x(_x), y(_y) {}
+    virtual ~Entity() = default;
+
+    void setX(int _x) { x = _x; }
+    void setY(int _y) { y = _y; }
+    int getX() const { return x; }
+    int getY() const { return y; }
+};
+
+class SnakeTail : public Entity {
+public:
+    SnakeTail() = default;
+    SnakeTail(int _x, int _y) : Entity(_x, _y) {}
+};
+
+class SnakeHead : public Entity
+{
+public:
+    SnakeHead() = default;
+    SnakeHead(int _x, int _y) : Entity(_x, _y) {}
+};
+
+class Empty : public Entity
+{
+public:
+    Empty() = default;
+    Empty(int _x, int _y) : Entity(_x, _y) {}
+};
+
+class Food : public Entity
+{
+public:
+    Food() = default;
+    Food(int _x, int _y) : Entity(_x, _y) {}
+};
+
+// Seed from std::random_device
+uint64_t randomSeed();
+
+// The game, specialized over the board size and the rule policies of
+// snakerules.hpp. SnakeGL is the generic instantiation that reads the board size,
+// walls and growth from a GameConfig at runtime.
+template <typename Size, typename Edges = WrapEdges, typename Growth = GrowBy<1>, typename Speed = ClassicSpeed>
+class BasicSnakeGL
+{
+private:
+    Size size;
+    SnakeState state;           // Head, tail tip, food, score, ... (snakestate.hpp)
+    AlignedBuffer<uint8_t> cells; // CELL per board cell
+    Bitboard occupied;          // Head and tail cells
+    FreeCells freeCells;        // Counts of the other cells, food spawns on one of them
+
+    void spawnFood();
+    void enterCell(int x, int y);
+    void leaveCell(int x, int y);
+
+    // Zobrist bookkeeping: XOR a key into every maintained hash, once to take
+    // a value out and once to put the new one in
+    void hashSymmetries(uint32_t index, uint8_t value);
+    void hashFood();
+    void hashDirection();
+    void hashGrow();
+    // Key of a cell value for hash[0], which the tick updates once at the end.
+    // The symmetric hashes, if kept, are updated right away.
+    inline uint64_t cellKey(uint32_t index, uint8_t value)
+    {
+        if (state.hashes > 1) hashSymmetries(index, value);
+        return Zobrist::cell(index, value);
+    }
+
+public:
+    // Seeded from std::random_device, every game is different
+    BasicSnakeGL() : BasicSnakeGL(randomSeed()) {}
+    // Same seed and same inputs reproduce the same game
+    explicit BasicSnakeGL(uint64_t seed) : BasicSnakeGL(GameConfig(), SnakeRng(seed)) {}
+    // Continue an existing random stream (e.g. the next game of a batch slot)
+    explicit BasicSnakeGL(const SnakeRng& _rng) : BasicSnakeGL(GameConfig(), _rng) {}
+    // Any board size up to 65535x65535 (memory permitting)
+    BasicSnakeGL(int _width, int _height, uint64_t seed) : BasicSnakeGL(GameConfig{ _width, _height }, SnakeRng(seed)) {}
+    BasicSnakeGL(int _width, int _height, const SnakeRng& _rng) : BasicSnakeGL(GameConfig{ _width, _height }, _rng) {}
+    // Fixed sizes and fixed rules ignore the matching config fields
+    BasicSnakeGL(const GameConfig& config, const SnakeRng& _rng);
+
+    // One tick: apply the action, move the snake and report what happened.
+    // Once GAME_OVER was returned the game stays finished.
+    StepResult step(INPUT_TYPE action);
+
+    // step() that also records the tick in log, undo(log) takes it back
+    StepResult step(INPUT_TYPE action, UndoLog& log);
+    void undo(UndoLog& log);
+
+    STEP_STATUS updateSnake();
+    void handleInput(INPUT_TYPE inputType);
+
+    // Copy of the whole game into snapshotBytes() bytes of caller memory, no
+    // allocation. restore() only accepts snapshots of a game with the same
+    // GameConfig, the rules themselves are not part of the snapshot.
+    size_t snapshotBytes() const { return sizeof(SnakeState) + cells.bytes() + occupied.bytes() + freeCells.stateBytes(); }
+    void snapshot(void* arena) const;
+    void restore(const void* arena);
+    // restore() of a snapshot read from outside, e.g. a replay file: checks
+    // that it is a consistent position of this config first. On false the
+    // game must be reset or restored again before it is used.
+    bool restoreChecked(const void* arena);
+
+    inline SnakeHead getHead() const { return SnakeHead(state.headX, state.headY); }
+    inline SnakeTail getTailTip() const { return SnakeTail(state.tailX, state.tailY); }
+    inline int getLength() const { return state.length; }
+    inline int getWidth() const { return size.width(); }
+    inline int getHeight() const { return size.height(); }
+    inline bool hasWalls() const { return Edges::solid(size); }
+    inline uint8_t getCell(int x, int y) const { return cells[(size_t)y * size.width() + x]; }
+
+    // Neighbour of a cell with wrap-around on every edge
+    inline void moveCell(int& x, int& y, INPUT_TYPE direction) const
+    {
+        size.wrapStep(x, y, direction);
+    }
+
+    // Visit every snake cell from the tail tip to the head, fn(x, y)
+    template <typename F>
+    void forEachSegment(F fn) const
+    {
+        int x = state.tailX, y = state.tailY;
+        for (int i = 1; i < state.length; i++) {
+            fn(x, y);
+            moveCell(x, y, (INPUT_TYPE)(getCell(x, y) & 3));
+        }
+        fn(x, y);
+    }
+
+    // Bytes of board memory held by this game
+    size_t memoryBytes() const { return cells.bytes() + occupied.bytes() + freeCells.bytes(); }
+    inline PAGE_KIND getCellPageKind() const { return cells.pageKind(); }
+    const inline Bitboard& getOccupancy() const { return occupied; }
+    inline bool isSnake(int x, int y) const { return occupied.test(x, y); }
+    inline INPUT_TYPE getDir() const { return (INPUT_TYPE)state.direction; }
+    // Food is at (-1, -1) once the snake covers the whole board
+    inline Food getFood() const { return Food(state.foodX, state.foodY); }
+    const inline FreeCells& getFreeCells() const { return freeCells; }
+    inline int getScore() const { return state.score; }
+    inline bool isGameOver() const { return state.gameOver != 0; }
+    inline int getTickDuration() const { return state.tickDuration; }
+    inline const SnakeRng& getRng() const { return state.rng; }
+    // Draw the following food from another stream, e.g. so a planner's
+    // simulations do not see where the real food will appear
+    inline void setRng(const SnakeRng& _rng) { state.rng = _rng; }
+    const inline SnakeState& getState() const { return state; }
+
+    // Zobrist hash of the position (zobrist.hpp), updated in O(1) per tick
+    inline uint64_t getHash() const { return state.hash[0]; }
+    // Also keep the hashes of the 7 mirrored and rotated positions up to date,
+    // so getCanonicalHash() is equal for all 8 of them. Square boards only,
+    // returns false on any other board.
+    bool setSymmetricHashing(bool enabled);
+    // Smallest hash over the symmetries, getHash() while symmetric hashing is off
+    uint64_t getCanonicalHash() const;
+    // Hash of the position under a symmetry, from scratch over the whole board
+    uint64_t computeHash(int symmetry = 0) const;
+};
+
+using SnakeGL = BasicSnakeGL<DynamicSize, ConfigEdges, ConfigGrowth>;
+
+// Runtime dispatch to a specialized instantiation: the configurations we run
+// a lot get their own compiled kernel, everything else the generic SnakeGL.
+// fn is called with the freshly constructed game, e.g. a generic lambda.
+template <typename F>
+void dispatchSnakeGL(const GameConfig& config, const SnakeRng& rng, F&& fn)
+{
+    if (config.growth == 1) {
+        if (config.width == 20 && config.height == 20 && !config.walls) {
+            BasicSnakeGL<FixedSize<20, 20>, WrapEdges> game(config, rng);
+            fn(game);
+            return;
+        }
+        if (config.width == 64 && config.height == 64 && config.walls) {
+            BasicSnakeGL<FixedSize<64, 64>, SolidWalls> game(config, rng);
+            fn(game);
+            return;
+        }
+        if (config.width == 256 && config.height == 256 && !config.walls) {
+            BasicSnakeGL<FixedSize<256, 256>, WrapEdges> game(config, rng);
+            fn(game);
+            return;
+        }
+    }
+    SnakeGL game(config, rng);
+    fn(game);
+}
+// ----------------------------------------------------------
+
+// Class definitions
+// ----------------------------------------------------------
+template <typename Size, typename Edges, typename Growth, typename Speed>
+BasicSnakeGL<Size, Edges, Growth, Speed>::BasicSnakeGL(const GameConfig& config, const SnakeRng& _rng)
+    : size(config), cells((size_t)size.width() * size.height(), CELL_EMPTY), occupied(size.width(), size.height()),
+    freeCells(occupied)
+{
+    state.headX = state.tailX = size.width() / 2;
+    state.headY = state.tailY = size.height() / 2;
+    state.direction = UP;
+    state.tickDuration = Speed::INITIAL;
+    state.rng = _rng;
+    hashDirection();
+    const uint32_t headCell = (uint32_t)state.headY * size.width() + state.headX;
+    cells[headCell] = CELL_HEAD;
+    state.hash[0] ^= cellKey(headCell, CELL_HEAD);
+    enterCell(state.headX, state.headY);
+    spawnFood();
+}
+
+template <typename Size, typename Edges, typename Growth, typename Speed>
+void BasicSnakeGL<Size, Edges, Growth, Speed>::spawnFood()
+{
+    // Any cell not covered by the snake, uniformly
+    hashFood();
+    if (freeCells.empty()) {
+        state.foodX = state.foodY = -1;
+        return;
+    }
+    uint32_t cell = freeCells.sample(occupied, state.rng);
+
+    state.foodX = cell % size.width();
+    state.foodY = cell / size.width();
+    hashFood();
+}
+
+template <typename Size, typename Edges, typename Growth, typename Speed>
+void BasicSnakeGL<Size, Edges, Growth, Speed>::hashSymmetries(uint32_t index, uint8_t value)
+{
+    for (int s = 1; s < state.hashes; s++) {
+        int x = index % size.width(), y = index / size.width();
+        Zobrist::transform(s, size.width(), x, y);
+        state.hash[s] ^= Zobrist::cell((uint32_t)y * size.width() + x, Zobrist::transformValue(s, value));
+    }
+}
+
+template <typename Size, typename Edges, typename Growth, typename Speed>
+void BasicSnakeGL<Size, Edges, Growth, Speed>::hashFood()
+{
+    if (state.foodX < 0) return;
+    state.hash[0] ^= Zobrist::food((uint32_t)state.foodY * size.width() + state.foodX, state.foodX);
+    for (int s = 1; s < state.hashes; s++) {
+        int x = state.foodX, y = state.foodY;
+        Zobrist::transform(s, size.width(), x, y);
+        state.hash[s] ^= Zobrist::food((uint32_t)y * size.width() + x, x);
+    }
+}
+
+template <typename Size, typename Edges, typename Growth, typename Speed>
+void BasicSnakeGL<Size, Edges, Growth, Speed>::hashDirection()
+{
+    for (int s = 0; s < state.hashes; s++) {
+        state.hash[s] ^= Zobrist::direction(Zobrist::transformDirection(s, state.direction));
+    }
+}
+
+template <typename Size, typename Edges, typename Growth, typename Speed>
+void BasicSnakeGL<Size, Edges, Growth, Speed>::hashGrow()
+{
+    uint64_t key = Zobrist::grow(state.growPending);
+    for (int s = 0; s < state.hashes; s++) state.hash[s] ^= key;
+}
+
+template <typename Size, typename Edges, typename Growth, typename Speed>
+bool BasicSnakeGL<Size, Edges, Growth, Speed>::setSymmetricHashing(bool enabled)
+{
+    if (enabled && size.width() != size.height()) return false;
+    state.hashes = enabled ? Zobrist::SYMMETRIES : 1;
+    for (int s = 1; s < Zobrist::SYMMETRIES; s++) {
+        state.hash[s] = enabled ? computeHash(s) : 0;
+    }
+    return true;
+}
+
+template <typename Size, typename Edges, typename Growth, typename Speed>
+uint64_t BasicSnakeGL<Size, Edges, Growth, Speed>::getCanonicalHash() const
+{
+    uint64_t best = state.hash[0];
+    for (int s = 1; s < state.hashes; s++) {
+        if (state.hash[s] < best) best = state.hash[s];
+    }
+    return best;
+}
+
+template <typename Size, typename Edges, typename Growth, typename Speed>
+uint64_t BasicSnakeGL<Size, Edges, Growth, Speed>::computeHash(int symmetry) const
+{
+    const int width = size.width();
+    uint64_t hash = Zobrist::direction(Zobrist::transformDirection(symmetry, state.direction)) ^ Zobrist::grow(state.growPending);
+    for (int y = 0; y < size.height(); y++) {
+        for (int x = 0; x < width; x++) {
+            uint8_t value = cells[(size_t)y * width + x];
+            if (value == CELL_EMPTY) continue;
+            int tx = x, ty = y;
+            Zobrist::transform(symmetry, width, tx, ty);
+            hash ^= Zobrist::cell((uint32_t)ty * width + tx, Zobrist::transformValue(symmetry, value));
+        }
+    }
+    if (state.foodX >= 0) {
+        int tx = state.foodX, ty = state.foodY;
+        Zobrist::transform(symmetry, width, tx, ty);
+        hash ^= Zobrist::food((uint32_t)ty * width + tx, tx);
+    }
+    return hash;
+}
+
+template <typename Size, typename Edges, typename Growth, typename Speed>
+void BasicSnakeGL<Size, Edges, Growth, Speed>::enterCell(int x, int y)
+{
+    occupied.set(x, y);
+    freeCells.take(x, y);
+}
+
+template <typename Size, typename Edges, typename Growth, typename Speed>
+void BasicSnakeGL<Size, Edges, Growth, Speed>::leaveCell(int x, int y)
+{
+    occupied.reset(x, y);
+    freeCells.release(x, y);
+}
+
+template <typename Size, typename Edges, typename Growth, typename Speed>
+void BasicSnakeGL<Size, Edges, Growth, Speed>::snapshot(void* arena) const
+{
+    uint8_t* out = (uint8_t*)arena;
+    memcpy(out, &state, sizeof(SnakeState));
+    out += sizeof(SnakeState);
+    memcpy(out, cells.data(), cells.bytes());
+    out += cells.bytes();
+    occupied.save(out);
+    out += occupied.bytes();
+    freeCells.save(out);
+}
+
+template <typename Size, typename Edges, typename Growth, typename Speed>
+void BasicSnakeGL<Size, Edges, Growth, Speed>::restore(const void* arena)
+{
+    const uint8_t* in = (const uint8_t*)arena;
+    memcpy(&state, in, sizeof(SnakeState));
+    in += sizeof(SnakeState);
+    memcpy(cells.data(), in, cells.bytes());
+    in += cells.bytes();
+    occupied.load(in);
+    in += occupied.bytes();
+    freeCells.load(in);
+}
+
+template <typename Size, typename Edges, typename Growth, typename Speed>
+bool BasicSnakeGL<Size, Edges, Growth, Speed>::restoreChecked(const void* arena)
+{
+    restore(arena);
+
+    const int width = size.width();
+    const int height = size.height();
+    const int64_t boardCells = (int64_t)width * height;
+    auto inside = [&](int x, int y) { return x >= 0 && x < width && y >= 0 && y < height; };
+    if (state.length < 1 || state.length > boardCells) return false;
+    if (state.direction < 0 || state.direction > 3 || state.growPending < 0) return false;
+    if (state.gameOver != 0 && state.gameOver != 1) return false;
+    if (state.hashes != 1 && !(state.hashes == Zobrist::SYMMETRIES && width == height)) return false;
+    if (!inside(state.headX, state.headY) || !inside(state.tailX, state.tailY)) return false;
+    if (!(state.foodX == -1 && state.foodY == -1) && (!inside(state.foodX, state.foodY) || occupied.test(state.foodX, state.foodY))) return false;
+
+    // Cells and occupancy agree word by word (row padding clear), and only the
+    // snake's cells are taken: as many cells as bits, and a cell under each bit
+    const int wordsPerRow = occupied.getWordsPerRow();
+    uint8_t invalid = 0;
+    for (int y = 0; y < height; y++) {
+        const uint8_t* row = &cells[(size_t)y * width];
+        for (int word = 0; word < wordsPerRow; word++) {
+            const int begin = word * 64;
+            const int end = std::min(width, begin + 64);
+            int taken = 0;
+            for (int x = begin; x < end; x++) {
+                // Values 0, CELL_HEAD and CELL_BODY | direction only
+                invalid |= (row[x] > 7) | ((row[x] & 6) == 2);
+                taken += row[x] != CELL_EMPTY;
+            }
+            uint64_t bits = occupied.row(y)[word];
+            if (end - begin < 64 && bits >> (end - begin)) return false;
+            if ((int)std::bitset<64>(bits).count() != taken) return false;
+            for (; bits; bits &= bits - 1) {
+                if (row[begin + std::bitset<64>((bits & (0 - bits)) - 1).count()] == CELL_EMPTY) return false;
+            }
+        }
+    }
+    if (invalid || (int64_t)occupied.count() != state.length) return false;
+
+    // The body leads from the tail tip to the head
+    if (getCell(state.headX, state.headY) != CELL_HEAD) return false;
+    int x = state.tailX, y = state.tailY;
+    for (int i = 1; i < state.length; i++) {
+        if (!(getCell(x, y) & CELL_BODY)) return false;
+        moveCell(x, y, (INPUT_TYPE)(getCell(x, y) & 3));
+    }
+    if (x != state.headX || y != state.headY) return false;
+
+    // Free cell counts come from the occupancy, not from the snapshot
+    freeCells.rebuild(occupied);
+    return true;
+}
+
+template <typename Size, typename Edges, typename Growth, typename Speed>
+StepResult BasicSnakeGL<Size, Edges, Growth, Speed>::step(INPUT_TYPE action)
+{
+    int speedLevel = state.lastMultipleOfFive;
+
+    handleInput(action);
+    STEP_STATUS status = updateSnake();
+
+    return StepResult{ status, state.score, state.lastMultipleOfFive != speedLevel };
+}
+
+template <typename Size, typename Edges, typename Growth, typename Speed>
+StepResult BasicSnakeGL<Size, Edges, Growth, Speed>::step(INPUT_TYPE action, UndoLog& log)
+{
+    // Record everything updateSnake() is about to overwrite
+    TickUndo& undo = log.push();
+    undo.state = state;
+    handleInput(action);
+
+    int newX = state.headX;
+    int newY = state.headY;
+    undo.moved = !state.gameOver && Edges::move(size, newX, newY, (INPUT_TYPE)state.direction) && !occupied.test(newX, newY);
+    if (undo.moved) {
+        const uint32_t width = size.width();
+        undo.cell[0] = (uint32_t)state.headY * width + state.headX;
+        undo.tipLeft = state.growPending == 0;
+        undo.cell[1] = undo.tipLeft ? (uint32_t)state.tailY * width + state.tailX : undo.cell[0];
+        undo.cell[2] = (uint32_t)newY * width + newX;
+        for (int i = 0; i < 3; i++) undo.value[i] = cells[undo.cell[i]];
+    }
+
+    int speedLevel = undo.state.lastMultipleOfFive;
+    STEP_STATUS status = updateSnake();
+
+    return StepResult{ status, state.score, state.lastMultipleOfFive != speedLevel };
+}
+
+template <typename Size, typename Edges, typename Growth, typename Speed>
+void BasicSnakeGL<Size, Edges, Growth, Speed>::undo(UndoLog& log)
+{
+    const TickUndo& undo = log.pop();
+    if (undo.moved) {
+        // Reverse order of updateSnake(): the new head entered last, the tail tip left before it
+        const int width = size.width();
+        for (int i = 2; i >= 0; i--) {
+            const int x = undo.cell[i] % width, y = undo.cell[i] / width;
+            const bool taken = undo.value[i] != CELL_EMPTY;
+            cells[undo.cell[i]] = undo.value[i];
+            if (taken == occupied.test(x, y)) continue;
+            if (taken) enterCell(x, y);
+            else leaveCell(x, y);
+        }
+    }
+    state = undo.state;
+}
+
+template <typename Size, typename Edges, typename Growth, typename Speed>
+STEP_STATUS BasicSnakeGL<Size, Edges, Growth, Speed>::updateSnake()
+{
+    if (state.gameOver) return GAME_OVER;
+
+    int newX = state.headX;
+    int newY = state.headY;
+    const INPUT_TYPE direction = (INPUT_TYPE)state.direction;
+
+    // Collision detection with walls and tail (the only snake cell that can not be hit is the head itself)
+    if (!Edges::move(size, newX, newY, direction) || occupied.test(newX, newY)) {
+        state.gameOver = 1;
+        return GAME_OVER;
+    }
+
+    // The tail tip (or the head, if there is no tail yet) leaves its cell unless the snake grows
+    const uint32_t width = size.width();
+    const uint32_t oldHead = (uint32_t)state.headY * width + state.headX;
+    uint64_t hash = cellKey(oldHead, CELL_HEAD);
+    if (state.growPending > 0) {
+        cells[oldHead] = CELL_BODY | direction;
+        hash ^= cellKey(oldHead, CELL_BODY | direction);
+        state.length++;
+        hashGrow();
+        state.growPending--;
+        hashGrow();
+    }
+    else if (state.length == 1) {
+        cells[oldHead] = CELL_EMPTY;
+        leaveCell(state.headX, state.headY);
+        state.tailX = newX;
+        state.tailY = newY;
+    }
+    else {
+        // Follow the body one cell toward the head
+        cells[oldHead] = CELL_BODY | direction;
+        hash ^= cellKey(oldHead, CELL_BODY | direction);
+        const uint32_t tip = (uint32_t)state.tailY * width + state.tailX;
+        INPUT_TYPE next = (INPUT_TYPE)(cells[tip] & 3);
+        hash ^= cellKey(tip, cells[tip]);
+        cells[tip] = CELL_EMPTY;
+        leaveCell(state.tailX, state.tailY);
+        moveCell(state.tailX, state.tailY, next);
+    }
+
+    // Update head position
+    state.headX = newX;
+    state.headY = newY;
+    const uint32_t newHead = (uint32_t)newY * width + newX;
+    cells[newHead] = CELL_HEAD;
+    hash ^= cellKey(newHead, CELL_HEAD);
+    state.hash[0] ^= hash;
+    enterCell(newX, newY);
+
+    // Check if the snake has eaten the food
+    if (newY == state.foodY && newX == state.foodX)
+    {
+        ++state.score;
+        state.tickDuration = Speed::next(state.tickDuration, state.score, state.lastMultipleOfFive);
+        spawnFood();
+
+        // Extend tail by keeping its tip on the next moves
+        hashGrow();
+        state.growPending += Growth::segments(size);
+        hashGrow();
+        return ATE_FOOD;
+    }
+
+    return MOVED;
+}
+
+template <typename Size, typename Edges, typename Growth, typename Speed>
+void BasicSnakeGL<Size, Edges, Growth, Speed>::handleInput(INPUT_TYPE inputType)
+{
+    // Prevent reversing direction: only update the direction if the new input isn't opposite of the current direction
+    const INPUT_TYPE currentDirection = (INPUT_TYPE)state.direction;
+    if ((inputType == UP && currentDirection != DOWN) ||
+        (inputType == DOWN && currentDirection != UP) ||
+        (inputType == LEFT && currentDirection != RIGHT) ||
+        (inputType == RIGHT && currentDirection != LEFT)) {
+        hashDirection();
+        state.direction = inputType;
+        hashDirection();
+    }
+}
+// ----------------------------------------------------------
+
+#endif
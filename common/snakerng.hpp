@@ -0,0 +1,65 @@
+#ifndef SNAKERNG_HPP
+#define SNAKERNG_HPP
+
+#include <cstdint>
+
+// Counter-based random stream: the n-th value is a pure function of the key
+// and n (SplitMix64 finalizer over a Weyl sequence), so the whole generator is
+// 16 bytes, seeding costs nothing and games running in parallel can derive
+// independent streams from (seed, stream index) without talking to each other.
+class SnakeRng
+{
+private:
+    uint64_t key = 0;
+    uint64_t counter = 0;
+
+public:
+    static inline uint64_t mix(uint64_t x)
+    {
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    SnakeRng() = default;
+    SnakeRng(uint64_t seed, uint64_t stream = 0)
+        : key(mix(seed + 0x9E3779B97F4A7C15ull) ^ mix(stream * 0xD1B54A32D192ED03ull + 1)), counter(0) {}
+
+    // Continue a stream from a saved key/counter pair (replay files)
+    static inline SnakeRng fromState(uint64_t key, uint64_t counter)
+    {
+        SnakeRng rng;
+        rng.key = key;
+        rng.counter = counter;
+        return rng;
+    }
+
+    inline uint64_t next()
+    {
+        return mix(key + ++counter * 0x9E3779B97F4A7C15ull);
+    }
+
+    // Uniform value in [lo, hi]
+    inline int nextInRange(int lo, int hi)
+    {
+        uint64_t r = next() >> 32;
+        return lo + (int)((r * (uint32_t)(hi - lo + 1)) >> 32);
+    }
+
+    // Uniform value in [0, n), n > 0. Up to 2^32 it draws what nextInRange(0, n - 1) does.
+    inline uint64_t nextBelow(uint64_t n)
+    {
+        if (n <= 0x100000000ull) return ((next() >> 32) * n) >> 32;
+        // High half of the 128-bit product next() * n, from 32-bit pieces
+        uint64_t r = next();
+        uint64_t rLo = (uint32_t)r, rHi = r >> 32, nLo = (uint32_t)n, nHi = n >> 32;
+        uint64_t mid = rHi * nLo + ((rLo * nLo) >> 32);
+        return rHi * nHi + (mid >> 32) + ((rLo * nHi + (uint32_t)mid) >> 32);
+    }
+
+    inline uint64_t getKey() const { return key; }
+    inline uint64_t getCounter() const { return counter; }
+    inline bool operator==(const SnakeRng& other) const { return key == other.key && counter == other.counter; }
+};
+
+#endif
@@ -0,0 +1,193 @@
+#ifndef SNAKERULES_HPP
+#define SNAKERULES_HPP
+
+// Board sizes and rule policies BasicSnakeGL is built from. Fixed sizes and
+// fixed rules let the compiler drop the generic wrap arithmetic and branches,
+// the Dynamic/Config variants read everything from a GameConfig at runtime.
+
+// Constants
+// ----------------------------------------------------------
+// Default board size, SnakeGL also takes any size at runtime
+constexpr auto WIDTH = 20;
+constexpr auto HEIGHT = 20;
+// Replays store it: bump on any change to the rules below or in BasicSnakeGL
+constexpr int RULES_VERSION = 2;
+// ----------------------------------------------------------
+
+enum INPUT_TYPE
+{
+    UP,
+    DOWN,
+    LEFT,
+    RIGHT
+};
+
+// Runtime description of a game variant
+struct GameConfig
+{
+    int width = WIDTH;
+    int height = HEIGHT;
+    bool walls = false; // Leaving the board ends the game instead of wrapping around
+    int growth = 1;     // Segments added per food
+};
+
+// Speed curve: every fifth food makes the tick 5 ms shorter, down to 90 ms
+int gameSpeed(int speedValue, int score, int& lastMultipleOfFive);
+
+// Board size policies
+// ----------------------------------------------------------
+// Step offsets per direction. Adding width-1 / height-1 instead of subtracting
+// one keeps coordinates positive, a single wrap then brings them back on the board.
+struct DirectionTable
+{
+    int addX[4];
+    int addY[4];
+};
+
+constexpr DirectionTable makeDirectionTable(int width, int height)
+{
+    return DirectionTable{ { 0, 0, width - 1, 1 }, { height - 1, 1, 0, 0 } };
+}
+
+// Board size known at runtime, also carries the rest of the GameConfig
+class DynamicSize
+{
+private:
+    GameConfig config;
+    DirectionTable table;
+
+public:
+    DynamicSize(const GameConfig& _config = GameConfig())
+        : config(_config), table(makeDirectionTable(_config.width, _config.height)) {}
+
+    inline int width() const { return config.width; }
+    inline int height() const { return config.height; }
+    inline const GameConfig& getConfig() const { return config; }
+
+    // Torus neighbour, no modulo and no branch on the direction
+    inline void wrapStep(int& x, int& y, INPUT_TYPE direction) const
+    {
+        x += table.addX[direction];
+        y += table.addY[direction];
+        if (x >= config.width) x -= config.width;
+        if (y >= config.height) y -= config.height;
+    }
+};
+
+// Board size known at compile time. Power-of-two sizes wrap with a mask.
+template <int W, int H>
+class FixedSize
+{
+private:
+    static constexpr bool POWER_OF_TWO = (W & (W - 1)) == 0 && (H & (H - 1)) == 0;
+    static constexpr DirectionTable TABLE = makeDirectionTable(W, H);
+
+public:
+    FixedSize(const GameConfig& = GameConfig()) {}
+
+    static constexpr int width() { return W; }
+    static constexpr int height() { return H; }
+
+    static inline void wrapStep(int& x, int& y, INPUT_TYPE direction)
+    {
+        x += TABLE.addX[direction];
+        y += TABLE.addY[direction];
+        if constexpr (POWER_OF_TWO) {
+            x &= W - 1;
+            y &= H - 1;
+        }
+        else {
+            if (x >= W) x -= W;
+            if (y >= H) y -= H;
+        }
+    }
+};
+// ----------------------------------------------------------
+
+// Edge policies: move(size, x, y, direction) returns false if the snake hits a
+// wall, solid(size) tells whether there are walls
+// ----------------------------------------------------------
+struct WrapEdges
+{
+    template <typename Size>
+    static constexpr bool solid(const Size&) { return false; }
+
+    template <typename Size>
+    static inline bool move(const Size& size, int& x, int& y, INPUT_TYPE direction)
+    {
+        size.wrapStep(x, y, direction);
+        return true;
+    }
+};
+
+struct SolidWalls
+{
+    template <typename Size>
+    static constexpr bool solid(const Size&) { return true; }
+
+    template <typename Size>
+    static inline bool move(const Size& size, int& x, int& y, INPUT_TYPE direction)
+    {
+        static constexpr int dx[4] = { 0, 0, -1, 1 };
+        static constexpr int dy[4] = { -1, 1, 0, 0 };
+        int nextX = x + dx[direction];
+        int nextY = y + dy[direction];
+        if ((unsigned)nextX >= (unsigned)size.width() || (unsigned)nextY >= (unsigned)size.height()) return false;
+        x = nextX;
+        y = nextY;
+        return true;
+    }
+};
+
+// GameConfig::walls decides at runtime, needs DynamicSize
+struct ConfigEdges
+{
+    template <typename Size>
+    static inline bool solid(const Size& size) { return size.getConfig().walls; }
+
+    template <typename Size>
+    static inline bool move(const Size& size, int& x, int& y, INPUT_TYPE direction)
+    {
+        if (size.getConfig().walls) return SolidWalls::move(size, x, y, direction);
+        return WrapEdges::move(size, x, y, direction);
+    }
+};
+// ----------------------------------------------------------
+
+// Growth policies: segments(size) added per food
+// ----------------------------------------------------------
+template <int N>
+struct GrowBy
+{
+    template <typename Size>
+    static constexpr int segments(const Size&) { return N; }
+};
+
+// GameConfig::growth decides at runtime, needs DynamicSize
+struct ConfigGrowth
+{
+    template <typename Size>
+    static inline int segments(const Size& size) { return size.getConfig().growth; }
+};
+// ----------------------------------------------------------
+
+// Speed policies: tick length in milliseconds
+// ----------------------------------------------------------
+struct ClassicSpeed
+{
+    static constexpr int INITIAL = 150;
+    static inline int next(int tickDuration, int score, int& lastMultipleOfFive)
+    {
+        return gameSpeed(tickDuration, score, lastMultipleOfFive);
+    }
+};
+
+template <int MS>
+struct ConstantSpeed
+{
+    static constexpr int INITIAL = MS;
+    static inline int next(int, int, int&) { return MS; }
+};
+// ----------------------------------------------------------
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef SNAKESTATE_HPP
+#define SNAKESTATE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "alignedbuffer.hpp"
+#include "snakerng.hpp"
+
+// Flat game state for search: the scalars of a game in one trivially copyable
+// block, and a log of per-tick changes so a bot can take a tick back instead
+// of cloning the whole board.
+
+// Every scalar of a game. Together with the board buffers (cells, occupancy,
+// free cells) this is the whole game, BasicSnakeGL::snapshot() copies it verbatim.
+struct SnakeState
+{
+    int32_t headX = 0, headY = 0;
+    int32_t tailX = 0, tailY = 0;   // Tail tip, equal to the head while the snake is one cell long
+    int32_t length = 1;             // Snake cells, head included
+    int32_t direction = 0;          // INPUT_TYPE
+    int32_t foodX = -1, foodY = -1; // (-1, -1) once the snake covers the whole board
+    int32_t growPending = 0;        // The tail keeps its tip for this many moves
+    int32_t gameOver = 0;
+    int32_t score = 0;
+    int32_t lastMultipleOfFive = 0;
+    int32_t tickDuration = 0;       // Tick length in milliseconds
+    int32_t hashes = 1;             // Zobrist hashes kept up to date: 1, or all 8 symmetries
+    uint64_t hash[8] = {};          // hash[s]: Zobrist hash of the position under symmetry s
+    SnakeRng rng;                   // Food placement, advanced once per spawn
+};
+static_assert(std::is_trivially_copyable<SnakeState>::value, "SnakeState is copied with memcpy");
+
+// What one tick changed, enough to put the game back bit for bit
+struct TickUndo
+{
+    SnakeState state;       // Scalars before the tick
+    uint32_t cell[3];       // Board cells the tick wrote: old head, tail tip, new head
+    uint8_t value[3];       // Their contents before the tick
+    bool moved;             // false if the tick only ended (or found) the game over
+    bool tipLeft;           // The tail tip left its cell
+};
+
+// Last ticks of a game, newest on top. Memory is allocated once, when the log
+// is full the oldest tick is dropped.
+class UndoLog
+{
+private:
+    AlignedBuffer<TickUndo> entries;
+    size_t top = 0;     // Slot of the next push
+    size_t count = 0;
+
+public:
+    explicit UndoLog(size_t capacity = 64) : entries(capacity ? capacity : 1) {}
+
+    inline TickUndo& push()
+    {
+        TickUndo& entry = entries[top];
+        top = top + 1 == entries.size() ? 0 : top + 1;
+        if (count < entries.size()) count++;
+        return entry;
+    }
+    // The log must not be empty
+    inline const TickUndo& pop()
+    {
+        top = top == 0 ? entries.size() - 1 : top - 1;
+        count--;
+        return entries[top];
+    }
+
+    inline void clear() { top = count = 0; }
+    inline size_t size() const { return count; }
+    inline bool empty() const { return count == 0; }
+    inline size_t capacity() const { return entries.size(); }
+};
+
+#endif
@@ -0,0 +1,477 @@
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include "solver.hpp"
+
+// Helpers
+// ----------------------------------------------------------
+struct SolverTableHeader
+{
+    char magic[4];      // "SNKS"
+    int32_t width, height;
+    int32_t walls;
+    int32_t growth;
+    uint32_t reserved;
+    uint64_t count;     // Positions, then count PackedState keys and count SolverValue
+};
+static_assert(sizeof(SolverTableHeader) == 32, "keys start 16-byte aligned");
+
+static bool stepCell(int cell, int direction, int width, int height, bool wrap, int& next)
+{
+    int x = cell % width, y = cell / width;
+    switch (direction) {
+    case UP: y--; break;
+    case DOWN: y++; break;
+    case LEFT: x--; break;
+    default: x++; break;
+    }
+    if (x < 0 || y < 0 || x >= width || y >= height) {
+        if (!wrap) return false;
+        x = (x + width) % width;
+        y = (y + height) % height;
+    }
+    next = y * width + x;
+    return true;
+}
+
+static inline int stateLength(const PackedState& state) { return (int)((state.lo >> 12) & 63) + 1; }
+static inline int stateGrowPending(const PackedState& state) { return (int)((state.lo >> 18) & 63); }
+// Score and win, the part of a value that is compared
+static inline int valueRank(SolverValue value) { return value & 0xFF; }
+
+// fn(thread, begin, end) over [0, count) cut into one range per thread
+template <typename Fn>
+static void parallelFor(int threads, size_t count, Fn fn)
+{
+    if (threads <= 1 || count < 4096) {
+        fn(0, (size_t)0, count);
+        return;
+    }
+    std::vector<std::thread> workers;
+    const size_t chunk = (count + threads - 1) / threads;
+    for (int t = 1; t < threads; t++) {
+        size_t begin = std::min(count, t * chunk), end = std::min(count, begin + chunk);
+        workers.emplace_back(fn, t, begin, end);
+    }
+    fn(0, (size_t)0, std::min(count, chunk));
+    for (std::thread& worker : workers) worker.join();
+}
+// ----------------------------------------------------------
+
+// Class definitions
+// ----------------------------------------------------------
+PackedState SolverPosition::pack(int width, int height, bool wrap) const
+{
+    PackedState state;
+    state.lo = (uint64_t)body[0] | (uint64_t)food << 6 | (uint64_t)(length - 1) << 12 | (uint64_t)growPending << 18 |
+        (uint64_t)direction << 24;
+    for (int i = 1; i < length; i++) {
+        // The first direction from body[i] that gets to body[i - 1]
+        int direction = 0, next = -1;
+        while (direction < 3 && !(stepCell(body[i], direction, width, height, wrap, next) && next == body[i - 1])) direction++;
+        const int bit = 26 + 2 * (i - 1);
+        if (bit < 64) state.lo |= (uint64_t)direction << bit;
+        else state.hi |= (uint64_t)direction << (bit - 64);
+    }
+    return state;
+}
+
+void SolverPosition::unpack(const PackedState& state, int width, int height, bool wrap)
+{
+    body[0] = (uint8_t)(state.lo & 63);
+    food = (int)((state.lo >> 6) & 63);
+    length = stateLength(state);
+    growPending = stateGrowPending(state);
+    direction = (int)((state.lo >> 24) & 3);
+    for (int i = 1; i < length; i++) {
+        const int bit = 26 + 2 * (i - 1);
+        int toHead = (int)((bit < 64 ? state.lo >> bit : state.hi >> (bit - 64)) & 3);
+        int cell = body[i - 1];
+        stepCell(body[i - 1], toHead ^ 1, width, height, wrap, cell);
+        body[i] = (uint8_t)cell;
+    }
+}
+
+ShardedStateSet::ShardedStateSet() : shards(new Shard[SHARDS])
+{
+    for (int s = 0; s < SHARDS; s++) shards[s].slots.assign(1024, PackedState{ ~0ull, ~0ull });
+}
+
+void ShardedStateSet::grow(Shard& shard)
+{
+    // Empty slots are all ones, which no position packs to (its head cell would be 63)
+    const PackedState empty{ ~0ull, ~0ull };
+    std::vector<PackedState> old(shard.slots.size() * 2, empty);
+    old.swap(shard.slots);
+    const size_t mask = shard.slots.size() - 1;
+    for (const PackedState& state : old) {
+        if (state == empty) continue;
+        size_t slot = state.hash() & mask;
+        while (shard.slots[slot] != empty) slot = (slot + 1) & mask;
+        shard.slots[slot] = state;
+    }
+}
+
+bool ShardedStateSet::insert(const PackedState& state)
+{
+    const PackedState empty{ ~0ull, ~0ull };
+    const uint64_t hash = state.hash();
+    // The top bits pick the shard, the low bits the slot
+    Shard& shard = shards[hash >> 58];
+    std::lock_guard<std::mutex> guard(shard.lock);
+    size_t mask = shard.slots.size() - 1;
+    size_t slot = hash & mask;
+    while (shard.slots[slot] != empty) {
+        if (shard.slots[slot] == state) return false;
+        slot = (slot + 1) & mask;
+    }
+    shard.slots[slot] = state;
+    // At most half full
+    if (++shard.count * 2 > shard.slots.size()) grow(shard);
+    return true;
+}
+
+size_t ShardedStateSet::size() const
+{
+    size_t total = 0;
+    for (int s = 0; s < SHARDS; s++) total += shards[s].count;
+    return total;
+}
+
+size_t ShardedStateSet::memoryBytes() const
+{
+    size_t total = 0;
+    for (int s = 0; s < SHARDS; s++) total += shards[s].slots.capacity() * sizeof(PackedState);
+    return total;
+}
+
+std::vector<PackedState> ShardedStateSet::takeSorted()
+{
+    const PackedState empty{ ~0ull, ~0ull };
+    std::vector<PackedState> all;
+    all.reserve(size());
+    for (int s = 0; s < SHARDS; s++) {
+        for (const PackedState& state : shards[s].slots) {
+            if (state != empty) all.push_back(state);
+        }
+        std::vector<PackedState>().swap(shards[s].slots);
+        shards[s].count = 0;
+    }
+    std::sort(all.begin(), all.end());
+    return all;
+}
+
+SmallBoardSolver::SmallBoardSolver(const GameConfig& _config, int threads, uint64_t _maxStates)
+    : config(_config), maxStates(_maxStates), cells(_config.width * _config.height), wrap(!_config.walls)
+{
+    numThreads = threads > 0 ? threads : std::max(1, (int)std::thread::hardware_concurrency());
+}
+
+bool SmallBoardSolver::move(int cell, int direction, int& next) const
+{
+    return stepCell(cell, direction, config.width, config.height, wrap, next);
+}
+
+int SmallBoardSolver::successors(const SolverPosition& position, int action, std::vector<PackedState>& out) const
+{
+    // Same rules as BasicSnakeGL::handleInput() and updateSnake()
+    const int direction = (action ^ 1) == position.direction ? position.direction : action;
+    int head;
+    if (!move(position.body[0], direction, head)) return 0;
+    // The tail tip has not left yet, running into it is a collision too
+    for (int i = 0; i < position.length; i++) {
+        if (position.body[i] == head) return 0;
+    }
+
+    SolverPosition next;
+    next.direction = direction;
+    next.body[0] = (uint8_t)head;
+    if (position.growPending > 0) {
+        next.length = position.length + 1;
+        next.growPending = position.growPending - 1;
+    }
+    else {
+        next.length = position.length;
+        next.growPending = 0;
+    }
+    memcpy(next.body + 1, position.body, next.length - 1);
+
+    if (head != position.food) {
+        next.food = position.food;
+        out.push_back(next.pack(config.width, config.height, wrap));
+        return 1;
+    }
+
+    // Eaten: the food comes back on any free cell
+    next.growPending += config.growth;
+    bool occupied[SolverPosition::MAX_CELLS] = {};
+    for (int i = 0; i < next.length; i++) occupied[next.body[i]] = true;
+    for (int cell = 0; cell < cells; cell++) {
+        if (occupied[cell]) continue;
+        next.food = cell;
+        out.push_back(next.pack(config.width, config.height, wrap));
+    }
+    if (next.length == cells) {
+        next.food = SolverPosition::NO_FOOD;
+        out.push_back(next.pack(config.width, config.height, wrap));
+    }
+    return 2;
+}
+
+std::vector<SolverPosition> SmallBoardSolver::startPositions() const
+{
+    // One-cell snake in the middle heading up, as BasicSnakeGL starts, with the food anywhere else
+    std::vector<SolverPosition> positions;
+    SolverPosition position;
+    position.body[0] = (uint8_t)((config.height / 2) * config.width + config.width / 2);
+    for (int cell = 0; cell < cells; cell++) {
+        if (cell == position.body[0]) continue;
+        position.food = cell;
+        positions.push_back(position);
+    }
+    return positions;
+}
+
+int64_t SmallBoardSolver::indexOf(const PackedState& state) const
+{
+    auto it = std::lower_bound(states.begin(), states.end(), state);
+    return it != states.end() && *it == state ? it - states.begin() : -1;
+}
+
+bool SmallBoardSolver::lookup(const PackedState& state, SolverValue& value) const
+{
+    int64_t index = indexOf(state);
+    if (index < 0) return false;
+    value = values[index];
+    return true;
+}
+
+SolverValue SmallBoardSolver::startValue() const
+{
+    SolverValue worst = 0x7F | 0x80;
+    for (const SolverPosition& position : startPositions()) {
+        SolverValue value = 0;
+        lookup(position.pack(config.width, config.height, wrap), value);
+        if (valueRank(value) < valueRank(worst)) worst = value;
+    }
+    return worst;
+}
+
+bool SmallBoardSolver::enumerate()
+{
+    ShardedStateSet set;
+    std::vector<PackedState> frontier;
+    for (const SolverPosition& position : startPositions()) {
+        PackedState state = position.pack(config.width, config.height, wrap);
+        if (set.insert(state)) frontier.push_back(state);
+    }
+
+    std::vector<std::vector<PackedState>> found(numThreads);
+    while (!frontier.empty()) {
+        if (set.size() > maxStates) {
+            stats.states = set.size();
+            return false;
+        }
+        parallelFor(numThreads, frontier.size(), [&](int thread, size_t begin, size_t end) {
+            SolverPosition position;
+            std::vector<PackedState> next;
+            std::vector<PackedState>& out = found[thread];
+            for (size_t i = begin; i < end; i++) {
+                position.unpack(frontier[i], config.width, config.height, wrap);
+                for (int action = 0; action < 4; action++) {
+                    // Going back is ignored by the game, it is the same as going on
+                    if ((action ^ 1) == position.direction) continue;
+                    next.clear();
+                    successors(position, action, next);
+                    for (const PackedState& state : next) {
+                        if (set.insert(state)) out.push_back(state);
+                    }
+                }
+            }
+        });
+
+        size_t foundBytes = 0;
+        frontier.clear();
+        for (std::vector<PackedState>& out : found) {
+            foundBytes += out.capacity() * sizeof(PackedState);
+            frontier.insert(frontier.end(), out.begin(), out.end());
+            out.clear();
+        }
+        notePeak(set.memoryBytes() + foundBytes + frontier.capacity() * sizeof(PackedState));
+    }
+    std::vector<PackedState>().swap(frontier);
+
+    const size_t setBytes = set.memoryBytes();
+    states = set.takeSorted();
+    notePeak(setBytes + states.size() * sizeof(PackedState));
+    stats.states = states.size();
+    return true;
+}
+
+void SmallBoardSolver::solveLayer(const std::vector<uint32_t>& layer)
+{
+    const size_t count = layer.size();
+    // Up to three moves per position that stay in the layer (no food eaten)
+    std::vector<uint32_t> moveTo(count * 3);
+    std::vector<uint8_t> moveAction(count * 3), moves(count);
+    std::vector<SolverValue> next(count);
+
+    // Best food to eat, on the values of the longer layers
+    parallelFor(numThreads, count, [&](int, size_t begin, size_t end) {
+        SolverPosition position;
+        std::vector<PackedState> out;
+        for (size_t i = begin; i < end; i++) {
+            position.unpack(states[layer[i]], config.width, config.height, wrap);
+            // Dead end (or the board is covered): any move loses
+            SolverValue best = (SolverValue)(position.direction << 8);
+            if (position.length == cells) best |= 0x80;
+            int bestRank = -1;
+            moves[i] = 0;
+            for (int action = 0; action < 4; action++) {
+                if ((action ^ 1) == position.direction) continue;
+                out.clear();
+                int result = successors(position, action, out);
+                if (result == 0) continue;
+                if (result == 1) {
+                    int64_t index = indexOf(out[0]);
+                    if (index < 0) continue;
+                    moveTo[i * 3 + moves[i]] = (uint32_t)index;
+                    moveAction[i * 3 + moves[i]] = (uint8_t)action;
+                    moves[i]++;
+                    // Staying alive beats dying
+                    if (bestRank < 0) {
+                        best = (SolverValue)(action << 8);
+                        bestRank = 0;
+                    }
+                    continue;
+                }
+                // The food lands where it hurts most
+                int worstScore = 0x7F;
+                bool allWin = true;
+                for (const PackedState& state : out) {
+                    int64_t index = indexOf(state);
+                    SolverValue value = index < 0 ? 0 : values[index];
+                    worstScore = std::min(worstScore, solverScore(value));
+                    allWin = allWin && solverWin(value);
+                }
+                SolverValue value = (SolverValue)(std::min(worstScore + 1, 0x7F) | (allWin ? 0x80 : 0) | action << 8);
+                if (valueRank(value) > bestRank) {
+                    best = value;
+                    bestRank = valueRank(value);
+                }
+            }
+            next[i] = best;
+        }
+    });
+    for (size_t i = 0; i < count; i++) values[layer[i]] = next[i];
+
+    // Moving around without eating: take the best value within reach. A value
+    // only replaces a strictly worse one, so the actions never go in circles.
+    std::vector<uint8_t> changed(numThreads);
+    bool any = true;
+    while (any) {
+        stats.sweeps++;
+        std::fill(changed.begin(), changed.end(), 0);
+        parallelFor(numThreads, count, [&](int thread, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                SolverValue best = values[layer[i]];
+                for (int m = 0; m < moves[i]; m++) {
+                    SolverValue value = values[moveTo[i * 3 + m]];
+                    if (valueRank(value) > valueRank(best)) best = (SolverValue)(valueRank(value) | moveAction[i * 3 + m] << 8);
+                }
+                if (best != values[layer[i]]) changed[thread] = 1;
+                next[i] = best;
+            }
+        });
+        any = false;
+        for (uint8_t flag : changed) any = any || flag;
+        for (size_t i = 0; i < count; i++) values[layer[i]] = next[i];
+    }
+    notePeak(states.size() * (sizeof(PackedState) + sizeof(SolverValue)) + count * (3 * sizeof(uint32_t) + 4 + sizeof(SolverValue)));
+}
+
+bool SmallBoardSolver::solve()
+{
+    stats = SolverStats();
+    states.clear();
+    values.clear();
+    if (cells > SolverPosition::MAX_CELLS) return false;
+
+    auto start = std::chrono::steady_clock::now();
+    bool complete = enumerate();
+    auto enumerated = std::chrono::steady_clock::now();
+    stats.enumerateSeconds = std::chrono::duration<double>(enumerated - start).count();
+    if (!complete) return false;
+
+    // Layers by length + growPending, the longest first
+    std::vector<std::vector<uint32_t>> layers;
+    for (size_t i = 0; i < states.size(); i++) {
+        size_t total = stateLength(states[i]) + stateGrowPending(states[i]);
+        if (total >= layers.size()) layers.resize(total + 1);
+        layers[total].push_back((uint32_t)i);
+    }
+    values.assign(states.size(), 0);
+    for (size_t total = layers.size(); total-- > 0;) {
+        if (layers[total].empty()) continue;
+        stats.layers++;
+        solveLayer(layers[total]);
+        std::vector<uint32_t>().swap(layers[total]);
+    }
+
+    stats.solveSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - enumerated).count();
+    stats.complete = true;
+    return true;
+}
+
+bool SmallBoardSolver::writeTable(const char* path) const
+{
+    if (!stats.complete) return false;
+    FILE* file = fopen(path, "wb");
+    if (!file) return false;
+    SolverTableHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "SNKS", 4);
+    header.width = config.width;
+    header.height = config.height;
+    header.walls = config.walls ? 1 : 0;
+    header.growth = config.growth;
+    header.count = states.size();
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+        fwrite(states.data(), sizeof(PackedState), states.size(), file) == states.size() &&
+        fwrite(values.data(), sizeof(SolverValue), values.size(), file) == values.size();
+    return fclose(file) == 0 && ok;
+}
+
+bool SolverTable::open(const char* path)
+{
+    file.close();
+    count = 0;
+    if (!file.open(path) || file.getSize() < sizeof(SolverTableHeader)) return false;
+    const SolverTableHeader* header = (const SolverTableHeader*)file.getData();
+    if (memcmp(header->magic, "SNKS", 4) != 0 ||
+        file.getSize() != sizeof(SolverTableHeader) + header->count * (sizeof(PackedState) + sizeof(SolverValue))) {
+        file.close();
+        return false;
+    }
+    config.width = header->width;
+    config.height = header->height;
+    config.walls = header->walls != 0;
+    config.growth = header->growth;
+    count = header->count;
+    keys = (const PackedState*)(file.getData() + sizeof(SolverTableHeader));
+    values = (const SolverValue*)(keys + count);
+    return true;
+}
+
+bool SolverTable::lookup(const PackedState& state, SolverValue& value) const
+{
+    const PackedState* it = std::lower_bound(keys, keys + count, state);
+    if (it == keys + count || *it != state) return false;
+    value = values[it - keys];
+    return true;
+}
+// ----------------------------------------------------------
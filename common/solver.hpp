@@ -0,0 +1,200 @@
+#ifndef SOLVER_HPP
+#define SOLVER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "mappedfile.hpp"
+#include "snakegl.hpp"
+
+// Exhaustive solver for small boards. Every position reachable from the
+// start is enumerated breadth first, then solved backward: the value of a
+// position is the score the snake can still make for sure, whatever cells the
+// food spawns on (the food is played by an adversary, the worst case of the
+// random game), and whether it can be sure to cover the board.
+//
+// Positions are packed into 128 bits. Eating adds growth to length +
+// growPending and every other move keeps it, so positions fall into layers
+// that are solved from the longest snake down; inside a layer a position gets
+// the best value among the food it can eat and the layer positions it can move
+// to, repeated until nothing changes.
+//
+// The solved positions are written sorted to a table file that SolverTable
+// maps and searches, so a bot or a test can ask for the perfect move.
+
+// Position as bits, from the lowest: head cell (6), food cell (6, 63 when the
+// board is covered), length - 1 (6), growPending (6), direction (2), then two
+// bits per body cell from the neck to the tail tip: the INPUT_TYPE toward
+// the head, as the game stores it.
+struct PackedState
+{
+    uint64_t lo = 0, hi = 0;
+
+    inline bool operator==(const PackedState& other) const { return lo == other.lo && hi == other.hi; }
+    inline bool operator!=(const PackedState& other) const { return !(*this == other); }
+    inline bool operator<(const PackedState& other) const { return hi != other.hi ? hi < other.hi : lo < other.lo; }
+    inline uint64_t hash() const { return SnakeRng::mix(lo ^ SnakeRng::mix(hi + 0x9E3779B97F4A7C15ull)); }
+};
+
+// Solved value of a position: score (7 bits), win (1 bit), best action (2 bits)
+typedef uint16_t SolverValue;
+
+inline int solverScore(SolverValue value) { return value & 0x7F; }
+inline bool solverWin(SolverValue value) { return (value & 0x80) != 0; }
+inline INPUT_TYPE solverAction(SolverValue value) { return (INPUT_TYPE)((value >> 8) & 3); }
+
+// A position unpacked: cells as y * width + x, body[0] is the head
+struct SolverPosition
+{
+    static constexpr int NO_FOOD = 63;
+    static constexpr int MAX_CELLS = 52;    // 26 header bits + 2 per body cell fit 128
+
+    int food = NO_FOOD;
+    int length = 1;
+    int growPending = 0;
+    int direction = UP;
+    uint8_t body[MAX_CELLS];
+
+    PackedState pack(int width, int height, bool wrap) const;
+    void unpack(const PackedState& state, int width, int height, bool wrap);
+
+    // The game's position, for any BasicSnakeGL
+    template <typename Game>
+    static SolverPosition fromGame(const Game& game)
+    {
+        SolverPosition position;
+        const int width = game.getWidth();
+        position.length = game.getLength();
+        position.growPending = game.getState().growPending;
+        position.direction = game.getDir();
+        position.food = game.getFood().x < 0 ? NO_FOOD : game.getFood().y * width + game.getFood().x;
+        // Walk from the tail tip to the head, filling the body from the back
+        int x = game.getTailTip().x, y = game.getTailTip().y;
+        for (int i = position.length - 1; i > 0; i--) {
+            position.body[i] = (uint8_t)(y * width + x);
+            game.moveCell(x, y, (INPUT_TYPE)(game.getCell(x, y) & 3));
+        }
+        position.body[0] = (uint8_t)(game.getHead().y * width + game.getHead().x);
+        return position;
+    }
+};
+
+// Set of packed positions for many threads: the hash picks one of SHARDS open
+// addressing tables, each behind its own lock
+class ShardedStateSet
+{
+public:
+    static constexpr int SHARDS = 64;
+
+    ShardedStateSet();
+
+    // true if state was not in the set yet
+    bool insert(const PackedState& state);
+    size_t size() const;
+    size_t memoryBytes() const;
+    // Move every state out, sorted, and empty the set
+    std::vector<PackedState> takeSorted();
+
+private:
+    struct Shard
+    {
+        std::mutex lock;
+        std::vector<PackedState> slots;
+        size_t count = 0;
+    };
+    std::unique_ptr<Shard[]> shards;
+
+    static void grow(Shard& shard);
+};
+
+struct SolverStats
+{
+    uint64_t states = 0;
+    int layers = 0;
+    uint64_t sweeps = 0;        // Passes over layers until their values settled
+    size_t peakBytes = 0;       // Most memory the solver's own buffers held at once
+    double enumerateSeconds = 0, solveSeconds = 0;
+    bool complete = false;      // false if the state limit stopped the enumeration
+};
+
+class SmallBoardSolver
+{
+public:
+    // threads <= 0: one per hardware thread. Boards must have at most
+    // SolverPosition::MAX_CELLS cells.
+    SmallBoardSolver(const GameConfig& _config, int threads = 0, uint64_t _maxStates = 50000000);
+
+    // Enumerate and solve; false if there are more than maxStates positions
+    bool solve();
+
+    inline const SolverStats& getStats() const { return stats; }
+    inline size_t getStateCount() const { return states.size(); }
+    // Value of a position, false if it is not reachable
+    bool lookup(const PackedState& state, SolverValue& value) const;
+    // Value of the start position (before the first food spawns) with the
+    // worst food for the snake
+    SolverValue startValue() const;
+
+    // Table file for SolverTable
+    bool writeTable(const char* path) const;
+
+private:
+    GameConfig config;
+    int numThreads;
+    uint64_t maxStates;
+    int cells;
+    bool wrap;
+    std::vector<PackedState> states;    // Sorted
+    std::vector<SolverValue> values;
+    SolverStats stats;
+
+    // Head cell moved one step, false into a wall
+    bool move(int cell, int direction, int& next) const;
+    // Positions after action: one without a food eaten, or one per food
+    // spawn cell; returns 0 if the snake dies, 1 if it moved, 2 if it ate
+    int successors(const SolverPosition& position, int action, std::vector<PackedState>& out) const;
+    std::vector<SolverPosition> startPositions() const;
+    int64_t indexOf(const PackedState& state) const;
+    inline void notePeak(size_t bytes) { stats.peakBytes = bytes > stats.peakBytes ? bytes : stats.peakBytes; }
+    bool enumerate();
+    void solveLayer(const std::vector<uint32_t>& layer);
+};
+
+// Solved table mapped from a file. Lookups are binary searches over the
+// sorted positions, nothing is read into memory up front.
+class SolverTable
+{
+public:
+    bool open(const char* path);
+
+    inline bool isOpen() const { return file.isOpen(); }
+    inline uint64_t getStateCount() const { return count; }
+    inline const GameConfig& getConfig() const { return config; }
+
+    bool lookup(const PackedState& state, SolverValue& value) const;
+
+    // Value of the game's position, false if the table has no such position
+    // (another board, or a game over)
+    template <typename Game>
+    bool lookup(const Game& game, SolverValue& value) const
+    {
+        // fromGame() only fits the boards the table was solved for
+        if (game.getWidth() != config.width || game.getHeight() != config.height || game.hasWalls() != config.walls ||
+            game.getLength() > SolverPosition::MAX_CELLS) {
+            return false;
+        }
+        return lookup(SolverPosition::fromGame(game).pack(config.width, config.height, !config.walls), value);
+    }
+
+private:
+    MappedFile file;
+    GameConfig config;
+    uint64_t count = 0;
+    const PackedState* keys = nullptr;
+    const SolverValue* values = nullptr;
+};
+
+#endif
@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <cmath>
+
+#include "tickclock.hpp"
+
+// Class definitions
+// ----------------------------------------------------------
+void TimingHistogram::add(double microseconds)
+{
+    if (microseconds < 0) microseconds = 0;
+    const size_t last = bins.size() - 1;
+    size_t bin = (size_t)(microseconds / BIN_US);
+    bins[bin < last ? bin : last]++;
+    count++;
+    sum += microseconds;
+    if (microseconds > max) max = microseconds;
+}
+
+void TimingHistogram::clear()
+{
+    std::fill(bins.begin(), bins.end(), 0);
+    count = 0;
+    sum = max = 0;
+}
+
+double TimingHistogram::percentile(double p) const
+{
+    if (count == 0) return 0;
+    uint64_t rank = (uint64_t)(p * (count - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t bin = 0; bin + 1 < bins.size(); bin++) {
+        seen += bins[bin];
+        if (seen >= rank) return (bin + 1) * BIN_US;
+    }
+    return max;
+}
+
+TickClock::TickClock(int tickMs) : tick(std::chrono::milliseconds(tickMs)), lastDuration(tick)
+{
+    start(Clock::now());
+}
+
+void TickClock::start(Clock::time_point now)
+{
+    deadline = now + tick;
+    ticked = false;
+}
+
+int TickClock::advance(Clock::time_point now)
+{
+    int due = 0;
+    while (now >= deadline && due < MAX_CATCH_UP) {
+        if (ticked) jitter.add(std::abs(std::chrono::duration<double, std::micro>((now - lastTick) - lastDuration).count()));
+        ticked = true;
+        lastTick = now;
+        lastDuration = tick;
+        deadline += tick;
+        due++;
+    }
+    // Too far behind: start the grid again from now
+    while (now >= deadline) {
+        deadline += tick;
+        dropped++;
+    }
+    return due;
+}
+// ----------------------------------------------------------
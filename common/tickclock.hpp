@@ -0,0 +1,68 @@
+#ifndef TICKCLOCK_HPP
+#define TICKCLOCK_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Fixed-timestep game clock. Ticks are due on a grid of deadlines that
+// advances by the tick duration, so a late wakeup shortens the next wait
+// instead of shifting every later tick; the simulation thread sleeps until
+// nextDeadline() rather than polling.
+
+// Durations in 10 us bins, for percentiles of tick and input timings
+class TimingHistogram
+{
+public:
+    static constexpr double BIN_US = 10;
+
+    explicit TimingHistogram(double maxMicroseconds = 100000) : bins((size_t)(maxMicroseconds / BIN_US) + 1, 0) {}
+
+    void add(double microseconds);
+    void clear();
+
+    inline uint64_t getCount() const { return count; }
+    inline double getMean() const { return count ? sum / count : 0; }
+    inline double getMax() const { return max; }
+    // Upper edge of the bin holding the p-th fraction of the samples (p in [0, 1])
+    double percentile(double p) const;
+
+private:
+    std::vector<uint32_t> bins;     // The last bin holds everything above the maximum
+    uint64_t count = 0;
+    double sum = 0, max = 0;
+};
+
+class TickClock
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    // More ticks due than this at once (e.g. after the window was dragged)
+    // are dropped rather than played back to back
+    static constexpr int MAX_CATCH_UP = 3;
+
+    explicit TickClock(int tickMs);
+
+    void start(Clock::time_point now);
+    // Applies from the next deadline on, e.g. snake.getTickDuration() after a speed up
+    inline void setTickDuration(int tickMs) { tick = std::chrono::milliseconds(tickMs); }
+
+    // Number of ticks due at now, the deadline moves past them
+    int advance(Clock::time_point now);
+    inline Clock::time_point nextDeadline() const { return deadline; }
+
+    // |time between two ticks - tick duration|, in microseconds
+    inline const TimingHistogram& getJitter() const { return jitter; }
+    inline uint64_t getDropped() const { return dropped; }
+
+private:
+    Clock::duration tick;
+    Clock::time_point deadline, lastTick;
+    Clock::duration lastDuration;
+    bool ticked = false;
+    TimingHistogram jitter;
+    uint64_t dropped = 0;
+};
+
+#endif
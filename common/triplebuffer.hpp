@@ -0,0 +1,43 @@
+#ifndef TRIPLEBUFFER_HPP
+#define TRIPLEBUFFER_HPP
+
+#include <atomic>
+#include <cstdint>
+
+// Latest-value hand-off from one writer thread to one reader thread without
+// locks. The writer fills its back slot and swaps it with the middle one,
+// the reader swaps its front slot with the middle one when that holds
+// something newer. Neither side ever waits, the writer never touches the
+// slot being read and the reader always sees a complete value; values the
+// reader was too slow for are skipped.
+template <typename T>
+class TripleBuffer
+{
+private:
+    static constexpr uint8_t FRESH = 4; // The middle slot was published since the last update()
+
+    T slots[3];
+    std::atomic<uint8_t> middle{ 1 };
+    uint8_t back = 0;   // Writer's slot
+    uint8_t front = 2;  // Reader's slot
+
+public:
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Writer: fill this, then publish()
+    inline T& writeSlot() { return slots[back]; }
+    inline void publish() { back = middle.exchange((uint8_t)(back | FRESH), std::memory_order_acq_rel) & 3; }
+
+    // Reader: take the newest published value, false if there is none since the last call
+    inline bool update()
+    {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        front = middle.exchange(front, std::memory_order_acq_rel) & 3;
+        return true;
+    }
+    inline const T& readSlot() const { return slots[front]; }
+};
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef ZOBRIST_HPP
+#define ZOBRIST_HPP
+
+#include <cstdint>
+#include <utility>
+
+#include "snakerng.hpp"
+
+// Zobrist keys of a game position: the XOR of one key per non-empty board
+// cell (its CELL byte, which also encodes the body order), the food cell, the
+// direction and the pending growth. Keys are SnakeRng::mix of a tagged input
+// instead of table lookups, so boards of any size cost no key memory.
+// The score and the food random stream are not part of a position.
+struct Zobrist
+{
+    // Dihedral symmetries of a square board: bit 0 mirrors x, bit 1 mirrors y,
+    // bit 2 then swaps x and y. Symmetry 0 is the identity.
+    static constexpr int SYMMETRIES = 8;
+
+    static inline uint64_t key(uint64_t tag, uint64_t value)
+    {
+        return SnakeRng::mix((tag << 56) ^ value ^ 0x5A17F00Dull);
+    }
+
+    // Empty cells (value 0) have no key
+    static inline uint64_t cell(uint64_t index, uint8_t value)
+    {
+        return value ? key(1, index << 3 | value) : 0;
+    }
+    // No food (x < 0) has no key
+    static inline uint64_t food(uint64_t index, int x)
+    {
+        return x < 0 ? 0 : key(2, index);
+    }
+    static inline uint64_t direction(int direction)
+    {
+        return key(3, (uint64_t)direction);
+    }
+    static inline uint64_t grow(int growPending)
+    {
+        return growPending ? key(4, (uint64_t)growPending) : 0;
+    }
+
+    // Image of a cell on an n x n board
+    static inline void transform(int symmetry, int n, int& x, int& y)
+    {
+        if (symmetry & 1) x = n - 1 - x;
+        if (symmetry & 2) y = n - 1 - y;
+        if (symmetry & 4) std::swap(x, y);
+    }
+    // Image of an INPUT_TYPE: mirroring x swaps LEFT/RIGHT, mirroring y swaps
+    // UP/DOWN, swapping the axes maps UP/DOWN to LEFT/RIGHT
+    static inline int transformDirection(int symmetry, int direction)
+    {
+        if ((symmetry & 1) && direction >= 2) direction ^= 1;
+        if ((symmetry & 2) && direction < 2) direction ^= 1;
+        if (symmetry & 4) direction ^= 2;
+        return direction;
+    }
+    // Image of a CELL byte, body cells (4 | direction) point along the transformed direction
+    static inline uint8_t transformValue(int symmetry, uint8_t value)
+    {
+        return value >= 4 ? (uint8_t)(4 | transformDirection(symmetry, value & 3)) : value;
+    }
+};
+
+#endif
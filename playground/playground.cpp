@@ -3,6 +3,7 @@
 // Include standard headers
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 // Include GLFW
 #include <glfw3.h>
@@ -15,135 +16,85 @@ using namespace glm;
 
 
 #include <common/shader.hpp>
+#include <common/snakegl.hpp>
+#include <common/replay.hpp>
+#include <common/tickclock.hpp>
+#include <common/inputqueue.hpp>
+#include <common/triplebuffer.hpp>
 
-#include <vector>
-#include <array>
 #include <algorithm>
+#include <cstddef>
+#include <atomic>
 #include <chrono>
 #include <thread>
 #include <iostream>
-#include <random>
+#include <vector>
 
 // Constants
 // ----------------------------------------------------------
-int score = 0;
-int lastMultipleOfFive = 0;
-constexpr auto WIDTH = 20;
-constexpr auto HEIGHT = 20;
 constexpr auto WINDOW_WIDTH = 800;
 constexpr auto WINDOW_HEIGHT = 800;
-
-static constexpr int CELL_WIDTH = WINDOW_WIDTH / WIDTH;
-static constexpr int CELL_HEIGHT = WINDOW_HEIGHT / HEIGHT;
 // ----------------------------------------------------------
 
-// Forward declaration
-// ----------------------------------------------------------
-class Entity;
-class Empty;
-class SnakeTail;
-class SnakeHead;
-class SnakeGL;
+// Turns pressed since the last tick, filled by the key callback
+InputQueue inputQueue;
 
-enum INPUT_TYPE;
-
-void inline setColor(float r, float g, float b);
-void drawCell(float x, float y, const glm::vec3& color);
-void updateAnimationLoop(SnakeGL& snake); // Changed to non-const reference
-bool initializeWindow();
-bool initializeVertexbuffer();
-bool cleanupVertexbuffer();
-bool closeWindow();
-int gameSpeed(int speedValue);
-// ----------------------------------------------------------
-
-// Class definition
-// ----------------------------------------------------------
-enum INPUT_TYPE
+// What the renderer draws, published by the simulation thread after every tick
+struct BoardFrame
 {
-    UP,
-    DOWN,
-    LEFT,
-    RIGHT
+    int width = 0, height = 0;
+    std::vector<uint32_t> body;     // Cells (y * width + x) from the tail tip to the neck
+    int foodX = -1, foodY = -1;
+    // The head and the tail tip slide from where they were before the tick
+    int headX = 0, headY = 0, previousHeadX = 0, previousHeadY = 0;
+    int tailX = 0, tailY = 0, previousTailX = 0, previousTailY = 0;
+    std::chrono::steady_clock::time_point tickTime;
+    int tickDuration = 0;           // Milliseconds until the next tick
 };
 
-class Entity
+// One cell on screen, attributes 1-3 of the instanced draw
+struct CellInstance
 {
-public:
-    int x, y;
-
-    Entity() : x(0), y(0) {}
-    Entity(int _x, int _y) : x(_x), y(_y) {}
-    virtual ~Entity() = default;
-
-    void setX(int _x) { x = _x; }
-    void setY(int _y) { y = _y; }
-    int getX() const { return x; }
-    int getY() const { return y; }
+    float x, y;                     // Cell center in normalized coordinates
+    float previousX, previousY;     // Center before the tick
+    float r, g, b;
 };
 
-class SnakeTail : public Entity {
-public:
-    SnakeTail() = default;
-    SnakeTail(int _x, int _y) : Entity(_x, _y) {}
-};
+// Renderer state and statistics, main thread only
+std::vector<CellInstance> instances;
+GLint alphaUniform, cellSizeUniform;
+TimingHistogram frameTimes;
+uint64_t frameCount = 0, drawCalls = 0;
 
-class SnakeHead : public Entity
-{
-private:
-    std::vector<SnakeTail> tail;
-
-public:
-    SnakeHead() = default;
-    SnakeHead(int _x, int _y) : Entity(_x, _y) {}
-
-    // Method to return a non-const reference to tail
-    inline std::vector<SnakeTail>& getTail() { return tail; }
-
-    // Optionally, keep const getter for read-only access if needed elsewhere
-    inline const std::vector<SnakeTail>& getTail() const { return tail; }
-};
-
-class Empty : public Entity
-{
-public:
-    Empty() = default;
-    Empty(int _x, int _y) : Entity(_x, _y) {}
-};
-
-class Food : public Entity
-{
-public:
-    Food() = default;
-    Food(int _x, int _y) : Entity(_x, _y) {}
-};
-
-class SnakeGL
-{
-private:
-    SnakeHead head;
-    std::array<Entity, WIDTH* HEIGHT> grid;  // Using Empty instead of Entity
-    INPUT_TYPE currentDirection = UP;
-    Food food;
-
-public:
-    SnakeGL();
-    void updateSnake();
-    void handleInput(INPUT_TYPE inputType);
-
-    const inline SnakeHead& getHead() const { return head; }
-    const inline std::vector<SnakeTail>& getTail() const { return head.getTail(); }
-    const inline std::array<Entity, WIDTH* HEIGHT>& getGrid() const { return grid; }
-    const INPUT_TYPE getDir() { return currentDirection; }
-    const inline Food& getFood() const { return food; }
-};
+// Forward declaration
+// ----------------------------------------------------------
+void buildInstances(const BoardFrame& frame);
+void updateAnimationLoop(const BoardFrame& frame, bool changed);
+void captureFrame(const SnakeGL& snake, BoardFrame& frame, const SnakeHead& previousHead, const SnakeTail& previousTail);
+bool reportStep(const StepResult& result);
+bool initializeWindow();
+bool initializeVertexbuffer();
+bool cleanupVertexbuffer();
+bool closeWindow();
 // ----------------------------------------------------------
 
 // Function definition
 // ----------------------------------------------------------
-int main(void)
+int main(int argc, char** argv)
 {
-    SnakeGL snake{};
+    // --no-vsync: draw as fast as possible instead of once per display refresh
+    // --size N: play on an N x N board
+    bool vsync = true;
+    GameConfig config;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--no-vsync") == 0) vsync = false;
+        else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) config.width = config.height = std::max(2, atoi(argv[++i]));
+    }
+
+    // Every game is recorded, replays play back exactly from the seed and the inputs
+    const uint64_t seed = randomSeed();
+    SnakeGL snake(config, SnakeRng(seed));
+    ReplayWriter replay("last_game.snkr", config, SnakeRng(seed));
 
     // Initialize window
     bool windowInitialized = initializeWindow();
@@ -155,42 +106,65 @@ int main(void)
 
     // Create and compile our GLSL program from the shaders
     programID = LoadShaders("SimpleVertexShader.vertexshader", "SimpleFragmentShader.fragmentshader");
+    alphaUniform = glGetUniformLocation(programID, "alpha");
+    cellSizeUniform = glGetUniformLocation(programID, "cellSize");
 
-    auto lastUpdateTime = std::chrono::steady_clock::now();
-    int timeoutDuration = 150; // Timeout duration in milliseconds
+    glfwSwapInterval(vsync ? 1 : 0);
+
+    TripleBuffer<BoardFrame> frames;
+    captureFrame(snake, frames.writeSlot(), snake.getHead(), snake.getTailTip());
+    frames.publish();
+    std::atomic<bool> quit{ false };
+    TickClock clock(snake.getTickDuration());
 
     std::cout << "Score: 0\n" << "Speed Level at 5" << std::endl;
 
-    // Start animation loop until escape key is pressed
+    // The game ticks on its own thread, on a fixed grid of deadlines, so a
+    // slow buffer swap or a driver stall can not hold it up
+    std::thread simulation([&]() {
+        clock.start(std::chrono::steady_clock::now());
+        while (!quit) {
+            std::this_thread::sleep_until(clock.nextDeadline());
+            int ticks = clock.advance(std::chrono::steady_clock::now());
+            const SnakeHead previousHead = snake.getHead();
+            const SnakeTail previousTail = snake.getTailTip();
+            for (int tick = 0; tick < ticks && !quit; tick++) {
+                // One step per tick, with at most one queued turn
+                INPUT_TYPE dir = inputQueue.nextTurn(snake.getDir());
+                replay.record(dir);
+                if (!reportStep(snake.step(dir))) quit = true;
+                clock.setTickDuration(snake.getTickDuration());
+            }
+            captureFrame(snake, frames.writeSlot(), previousHead, previousTail);
+            frames.publish();
+        }
+    });
+
+    // Draw the newest tick at the display rate until escape key is pressed
     do
     {
-        auto currentTime = std::chrono::steady_clock::now();
-        auto elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - lastUpdateTime).count();
-
-        timeoutDuration = gameSpeed(timeoutDuration);
-
-        if (elapsedTime >= timeoutDuration) {
-            INPUT_TYPE dir = snake.getDir();
-            if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) dir = UP;
-            else if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) dir = DOWN;
-            else if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) dir = LEFT;
-            else if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) dir = RIGHT;
-
-            snake.handleInput(dir);
-            snake.updateSnake();
-            updateAnimationLoop(snake);
-
-            // Reset the last update time
-            lastUpdateTime = currentTime; // Reset last update time
-        }
-        else {
-            // Sleep for a short duration to prevent busy-waiting
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        }
+        glfwPollEvents();
+        bool changed = frames.update() || frameCount == 0;
+        updateAnimationLoop(frames.readSlot(), changed);
     } // Check if the ESC key was pressed or the window was closed
-    while (glfwGetKey(window, GLFW_KEY_ESCAPE) != GLFW_PRESS &&
+    while (!quit && glfwGetKey(window, GLFW_KEY_ESCAPE) != GLFW_PRESS &&
         glfwWindowShouldClose(window) == 0);
 
+    quit = true;
+    simulation.join();
+    const TimingHistogram& jitter = clock.getJitter();
+    printf("Tick jitter over %llu ticks: mean %.0f us, p99 %.0f us, max %.0f us, %llu dropped\n",
+        (unsigned long long)jitter.getCount(), jitter.getMean(), jitter.percentile(0.99), jitter.getMax(),
+        (unsigned long long)clock.getDropped());
+    const TimingHistogram& latency = inputQueue.getLatency();
+    printf("Input latency over %llu turns: mean %.1f ms, p99 %.1f ms, max %.1f ms\n", (unsigned long long)latency.getCount(),
+        latency.getMean() / 1000, latency.percentile(0.99) / 1000, latency.getMax() / 1000);
+    printf("%dx%d board, %llu frames: %.2f draw calls per frame, CPU frame time mean %.3f ms, p99 %.3f ms\n", config.width,
+        config.height, (unsigned long long)frameCount, frameCount ? (double)drawCalls / frameCount : 0.0,
+        frameTimes.getMean() / 1000, frameTimes.percentile(0.99) / 1000);
+
+    replay.close(snake.getScore(), snake.getHash());
+
     // Cleanup and close window
     cleanupVertexbuffer();
     glDeleteProgram(programID);
@@ -199,74 +173,109 @@ int main(void)
     return 0;
 }
 
-void updateAnimationLoop(SnakeGL& snake) {
-    // Clear the screen
-    glClear(GL_COLOR_BUFFER_BIT);
+// Print score changes, returns false once the game is over
+bool reportStep(const StepResult& result)
+{
+    if (result.status == GAME_OVER) {
+        std::cout << "Game Over!! -- Your Finale Score is " << result.score << "!!" << std::endl;
+        return false;
+    }
+    if (result.status == ATE_FOOD) {
+        std::cout << "Score: " << result.score << std::endl;
+    }
+    if (result.speedUp) {
+        std::cout << "Speed Level at " << result.score + 5 << std::endl;
+    }
+    return true;
+}
 
-    // Use the shader program
-    glUseProgram(programID);
+// Runs on the simulation thread, into the triple buffer's back slot
+void captureFrame(const SnakeGL& snake, BoardFrame& frame, const SnakeHead& previousHead, const SnakeTail& previousTail)
+{
+    frame.width = snake.getWidth();
+    frame.height = snake.getHeight();
+    // Walk the body from the tail tip, each cell points toward the head
+    frame.body.clear();
+    int x = snake.getTailTip().x, y = snake.getTailTip().y;
+    for (int i = snake.getLength() - 1; i > 0; i--) {
+        frame.body.push_back((uint32_t)y * frame.width + x);
+        snake.moveCell(x, y, (INPUT_TYPE)(snake.getCell(x, y) & 3));
+    }
+    frame.foodX = snake.getFood().x;
+    frame.foodY = snake.getFood().y;
+
+    frame.headX = snake.getHead().x;
+    frame.headY = snake.getHead().y;
+    frame.tailX = snake.getTailTip().x;
+    frame.tailY = snake.getTailTip().y;
+    // Only a step to a neighbour slides, a wrap around the board or a tick
+    // that was caught up jumps
+    auto neighbour = [](int x, int y, int toX, int toY) { return abs(toX - x) + abs(toY - y) <= 1; };
+    const bool headSlides = neighbour(previousHead.x, previousHead.y, frame.headX, frame.headY);
+    frame.previousHeadX = headSlides ? previousHead.x : frame.headX;
+    frame.previousHeadY = headSlides ? previousHead.y : frame.headY;
+    const bool tailSlides = neighbour(previousTail.x, previousTail.y, frame.tailX, frame.tailY);
+    frame.previousTailX = tailSlides ? previousTail.x : frame.tailX;
+    frame.previousTailY = tailSlides ? previousTail.y : frame.tailY;
+    frame.tickTime = std::chrono::steady_clock::now();
+    frame.tickDuration = snake.getTickDuration();
+}
 
+// Instances for the snake and the food; empty cells are the clear color
+void buildInstances(const BoardFrame& frame)
+{
     // Calculate the normalized dimensions for each cell
-    float cellWidth = 2.0f / WIDTH;  // Normalized width of each cell
-    float cellHeight = 2.0f / HEIGHT; // Normalized height of each cell
+    const float cellWidth = 2.0f / frame.width;  // Normalized width of each cell
+    const float cellHeight = 2.0f / frame.height; // Normalized height of each cell
 
     // Calculate offset to ensure the whole map is visible
-    float offsetX = -1.0f + (cellWidth / 2);
-    float offsetY = 1.0f - (cellHeight / 2);
+    const float offsetX = -1.0f + (cellWidth / 2);
+    const float offsetY = 1.0f - (cellHeight / 2);
 
-    // Check for key presses in the current frame to avoid "random" movement
-    INPUT_TYPE dir = snake.getDir(); // Get the current direction
+    // Flip Y to match OpenGL coordinates
+    auto add = [&](int x, int y, int previousX, int previousY, const glm::vec3& color) {
+        instances.push_back(CellInstance{ x * cellWidth + offsetX, offsetY - y * cellHeight, previousX * cellWidth + offsetX,
+            offsetY - previousY * cellHeight, color.r, color.g, color.b });
+    };
 
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) {
-        dir = UP;
-    }
-    else if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) {
-        dir = DOWN;
-    }
-    else if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) {
-        dir = LEFT;
-    }
-    else if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) {
-        dir = RIGHT;
-    }
+    instances.clear();
+    const glm::vec3 bodyColor(0.0f, 1.0f, 0.4f); // Green for the snake's body
+    for (uint32_t cell : frame.body) add(cell % frame.width, cell / frame.width, cell % frame.width, cell / frame.width, bodyColor);
+    if (frame.foodX >= 0) add(frame.foodX, frame.foodY, frame.foodX, frame.foodY, glm::vec3(1.0f, 0.0f, 0.0f)); // Red for the food
+    // The cell the tail tip left, and the head
+    add(frame.tailX, frame.tailY, frame.previousTailX, frame.previousTailY, bodyColor);
+    add(frame.headX, frame.headY, frame.previousHeadX, frame.previousHeadY, glm::vec3(0.0f, 0.8f, 0.4f));
 
-    // Update snake direction only if new input is valid (i.e., not opposite direction)
-    snake.handleInput(dir);
+    glBindBuffer(GL_ARRAY_BUFFER, instancebuffer);
+    glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(CellInstance), instances.data(), GL_STREAM_DRAW);
+}
 
-    // Update the snake's state (movement)
-    snake.updateSnake();
+void updateAnimationLoop(const BoardFrame& frame, bool changed) {
+    auto frameStart = std::chrono::steady_clock::now();
 
-    // Draw all the cells on the grid
-    for (int y = 0; y < HEIGHT; y++) {
-        for (int x = 0; x < WIDTH; x++) {
-            glm::vec3 cellColor(0.0f, 0.0f, 0.0f); // Default cell color (black)
+    // Clear the screen
+    glClear(GL_COLOR_BUFFER_BIT);
 
-            // Check if the current cell is the snake's head
-            if (snake.getHead().getX() == x && snake.getHead().getY() == y) {
-                cellColor = glm::vec3(0.0f, 0.8f, 0.4f); // Green for the snake's head
-            }
-            // Check if the current cell is part of the snake's body
-            else if (std::any_of(snake.getHead().getTail().begin(), snake.getHead().getTail().end(),
-                [x, y](const SnakeTail& tailSeg) {
-                    return tailSeg.getX() == x && tailSeg.getY() == y;
-                })) {
-                cellColor = glm::vec3(0.0f, 1.0f, 0.4f); // Green for the snake's body
-            }
-            else if (snake.getFood().x == x && snake.getFood().y == y)
-            {
-                cellColor = glm::vec3(1.0f, 0.0f, 0.0f); // Red for the food
-            }
+    // Use the shader program
+    glUseProgram(programID);
 
-            // Calculate the position of the cell in normalized coordinates
-            float xPos = (x * cellWidth) + offsetX;
-            float yPos = offsetY - (y * cellHeight); // Flip Y to match OpenGL coordinates
+    // The instance buffer only changes when a new tick came in
+    if (changed) buildInstances(frame);
 
-            drawCell(xPos, yPos, cellColor); // Draw the cell at the computed position
-        }
-    }
+    // How far the frame is into the tick: the head and the tail are drawn
+    // that far between their cells before and after it
+    float alpha = std::chrono::duration<float, std::milli>(frameStart - frame.tickTime).count() / std::max(1, frame.tickDuration);
+    glUniform1f(alphaUniform, std::min(alpha, 1.0f));
+    glUniform2f(cellSizeUniform, 2.0f / frame.width, 2.0f / frame.height);
 
+    // Every cell in one call
+    glBindVertexArray(VertexArrayID);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, (GLsizei)instances.size());
+    drawCalls++;
+
+    frameTimes.add(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - frameStart).count());
+    frameCount++;
     glfwSwapBuffers(window);
-    glfwPollEvents();
 }
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
@@ -275,6 +284,16 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height)
     glfwSetWindowSize(window, WINDOW_WIDTH, WINDOW_HEIGHT);
 }
 
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    // Presses only, holding a key down does not repeat the turn
+    if (action != GLFW_PRESS) return;
+    if (key == GLFW_KEY_W) inputQueue.push(UP);
+    else if (key == GLFW_KEY_S) inputQueue.push(DOWN);
+    else if (key == GLFW_KEY_A) inputQueue.push(LEFT);
+    else if (key == GLFW_KEY_D) inputQueue.push(RIGHT);
+}
+
 bool initializeWindow()
 {
     // Initialise GLFW
@@ -303,6 +322,8 @@ bool initializeWindow()
 
     // Set the callback to prevent resizing
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    // Turns are queued as the keys go down, so taps between ticks count
+    glfwSetKeyCallback(window, key_callback);
 
     glfwMakeContextCurrent(window);
     glViewport(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
@@ -320,8 +341,8 @@ bool initializeWindow()
     // Ensure we can capture the escape key being pressed below
     glfwSetInputMode(window, GLFW_STICKY_KEYS, GL_TRUE);
 
-    // Dark blue background
-    glClearColor(0.0f, 0.0f, 0.4f, 0.0f);
+    // Black background, the empty cells
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
 
     return true;
     }
@@ -346,6 +367,21 @@ bool initializeVertexbuffer()
     glGenBuffers(1, &vertexbuffer);
     glBindBuffer(GL_ARRAY_BUFFER, vertexbuffer);
     glBufferData(GL_ARRAY_BUFFER, sizeof(g_vertex_buffer_data), g_vertex_buffer_data, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+
+    // Per cell: position, previous position and color, advancing once per instance
+    glGenBuffers(1, &instancebuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, instancebuffer);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(CellInstance), (void*)offsetof(CellInstance, x));
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(CellInstance), (void*)offsetof(CellInstance, previousX));
+    glVertexAttribDivisor(2, 1);
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(CellInstance), (void*)offsetof(CellInstance, r));
+    glVertexAttribDivisor(3, 1);
 
     return true;
 }
@@ -354,6 +390,7 @@ bool cleanupVertexbuffer()
 {
     // Cleanup VBO
     glDeleteBuffers(1, &vertexbuffer);
+    glDeleteBuffers(1, &instancebuffer);
     glDeleteVertexArrays(1, &VertexArrayID);
     return true;
 }
@@ -363,140 +400,4 @@ bool closeWindow()
     glfwTerminate();
     return true;
 }
-
-void drawCell(float x, float y, const glm::vec3& color) {
-    // Set the color uniform
-    glUniform3f(glGetUniformLocation(programID, "inputColor"), color.r, color.g, color.b);
-
-    // Set the position uniform
-    glUniform2f(glGetUniformLocation(programID, "cellPosition"), x, y);
-
-    // Enable the vertex attribute array and bind the buffer
-    glEnableVertexAttribArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, vertexbuffer);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
-
-    // Draw the cell as a rectangle
-    glDrawArrays(GL_TRIANGLES, 0, 6); // Draw two triangles to form a rectangle
-
-    glDisableVertexAttribArray(0);
-}
-
-void inline setColor(float r, float g, float b)
-{
-    glUniform3f(glGetUniformLocation(programID, "ourColor"), r, g, b);
-}
 // ----------------------------------------------------------
-
-// Class definitions 
-// ----------------------------------------------------------
-SnakeGL::SnakeGL() : head(WIDTH / 2, HEIGHT / 2)
-{
-    std::for_each(grid.begin(), grid.end(), [](auto& item)
-        {
-            item = Empty();
-        });
-
-    grid[head.x, head.y] = head;
-
-    std::random_device rd;
-    std::mt19937 gen(rd()); // Mersenne Twister engine
-    std::uniform_int_distribution<int> distX(4, WIDTH - 2);
-    std::uniform_int_distribution<int> distY(5, HEIGHT - 2);
-    int rndXPos = distX(gen);
-    int rndYPos = distY(gen);
-
-    food = Food(rndXPos, rndYPos);
-    //std::cout << "Food_X: " << food.x << " Food_Y: " << food.y << std::endl; //to check the Pos
-}
-
-void SnakeGL::updateSnake()
-{
-    int newX = head.getX();
-    int newY = head.getY();
-
-    switch (currentDirection)
-    {
-    case UP:
-        newY = (newY - 1 + HEIGHT) % HEIGHT;
-        break;
-    case DOWN:
-        newY = (newY + 1) % HEIGHT;
-        break;
-    case LEFT:
-        newX = (newX - 1 + WIDTH) % WIDTH;
-        break;
-    case RIGHT:
-        newX = (newX + 1) % WIDTH;
-        break;
-    }
-
-
-
-    // Collision detection with tail
-    if (std::any_of(head.getTail().begin(), head.getTail().end(),
-        [newX, newY](const SnakeTail& segment) {
-            return segment.getX() == newX && segment.getY() == newY;
-        })) {
-        std::cout << "Game Over!! -- Your Finale Score is " << score << "!!" << std::endl; ////////////////////////////////////////////////////
-        exit(0); // Exit on collision
-    }
-
-    // Update tail positions
-    for (size_t i = head.getTail().size(); i > 1; --i) {
-        head.getTail()[i - 1].setX(head.getTail()[i - 2].getX());
-        head.getTail()[i - 1].setY(head.getTail()[i - 2].getY());
-    }
-    if (!head.getTail().empty()) {
-        head.getTail()[0].setX(head.getX());
-        head.getTail()[0].setY(head.getY());
-    }
-
-    // Update head position
-    head.setX(newX);
-    head.setY(newY);
-    grid[newY * WIDTH + newX] = head;
-
-    // Check if the snake has eaten the food ////////////////////////////////////////////////////////////// HEREE SCORE GETS UPDATED
-    if (newY == food.getY() && newX == food.getX())
-    {
-        std::cout << "Score: " << ++score << std::endl;
-
-        // Spawn new food
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<int> distX(4, WIDTH - 2);
-        std::uniform_int_distribution<int> distY(5, HEIGHT - 2);
-        food.setX(distX(gen));
-        food.setY(distY(gen));
-
-        //std::cout << "Food_X: " << food.x << " Food_Y: " << food.y << std::endl; //to check the Pos
-
-        // Extend tail by adding a new segment at the end
-        head.getTail().push_back(SnakeTail(newX, newY));
-    }
-}
-
-void SnakeGL::handleInput(INPUT_TYPE inputType)
-{
-    // Prevent reversing direction: only update the direction if the new input isn't opposite of the current direction
-    if ((inputType == UP && currentDirection != DOWN) ||
-        (inputType == DOWN && currentDirection != UP) ||
-        (inputType == LEFT && currentDirection != RIGHT) ||
-        (inputType == RIGHT && currentDirection != LEFT)) {
-        currentDirection = inputType;
-    }
-}
-
-int gameSpeed(int speedValue) {
-    int decreaseAmount = 0;
-
-    if (score % 5 == 0 && score != lastMultipleOfFive) {
-        lastMultipleOfFive = score;
-        decreaseAmount = 5;
-        
-        std::cout << "Speed Level at " << score+decreaseAmount << std::endl;
-    }
-
-    return std::max(90, speedValue - decreaseAmount);
-}
\ No newline at end of file
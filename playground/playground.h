@@ -6,6 +6,7 @@
 
 //some global variables for handling the vertex buffer
 GLuint vertexbuffer;
+GLuint instancebuffer; // position, previous position and color of every cell drawn
 GLuint VertexArrayID;
 GLuint vertexbuffer_size;
 
@@ -13,8 +14,7 @@ GLuint vertexbuffer_size;
 GLuint programID;
 
 
-int main( void ); //<<< main function, called at startup
-void updateAnimationLoop(); //<<< updates the animation loop
+int main( int argc, char** argv ); //<<< main function, called at startup
 bool initializeWindow(); //<<< initializes the window using GLFW and GLEW
 bool initializeVertexbuffer(); //<<< initializes the vertex buffer array and binds it OpenGL
 bool cleanupVertexbuffer(); //<<< frees all recources from the vertex buffer
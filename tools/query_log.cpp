@@ -0,0 +1,76 @@
+// Queries over a columnar analytics log (common/analyticslog.hpp). Only the
+// columns a query needs are decoded, blocks are skipped on their min/max.
+//
+// usage: query_log <log> info
+//        query_log <log> avg <column> where <column> <value>
+//        query_log <log> deaths-near-walls <distance> [rows to print]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+
+#include <common/analyticslog.hpp>
+
+static int usage(const char* program)
+{
+    fprintf(stderr, "usage: %s <log> info\n", program);
+    fprintf(stderr, "       %s <log> avg <column> where <column> <value>\n", program);
+    fprintf(stderr, "       %s <log> deaths-near-walls <distance> [rows to print]\n", program);
+    fprintf(stderr, "columns:");
+    for (int c = 0; c < COLUMN_COUNT; c++) fprintf(stderr, " %s", columnName((LOG_COLUMN)c));
+    fprintf(stderr, "\n");
+    return 2;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3) return usage(argv[0]);
+
+    AnalyticsLog log;
+    if (!log.open(argv[1])) {
+        fprintf(stderr, "%s is not an analytics log\n", argv[1]);
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    const char* query = argv[2];
+    if (strcmp(query, "info") == 0) {
+        printf("%llu rows in %zu blocks of %u, %dx%d board, %.1f MB\n", (unsigned long long)log.getRows(), log.getBlockCount(),
+            log.getBlockRows(), log.getWidth(), log.getHeight(), log.getFileBytes() / (1024.0 * 1024.0));
+        for (int c = 0; c < COLUMN_COUNT; c++) {
+            size_t bytes = log.getColumnBytes((LOG_COLUMN)c);
+            printf("  %-8s %12zu bytes %8.3f bits/row\n", columnName((LOG_COLUMN)c), bytes,
+                log.getRows() ? 8.0 * bytes / log.getRows() : 0.0);
+        }
+    }
+    else if (strcmp(query, "avg") == 0 && argc == 7 && strcmp(argv[4], "where") == 0) {
+        LOG_COLUMN column, where;
+        if (!columnFromName(argv[3], column) || !columnFromName(argv[5], where)) return usage(argv[0]);
+        int64_t value = strtoll(argv[6], nullptr, 10);
+
+        ColumnAverage result = averageWhere(log, column, where, value);
+        printf("avg(%s) where %s = %lld: %.4f over %llu rows\n", argv[3], argv[5], (long long)value, result.average,
+            (unsigned long long)result.rows);
+    }
+    else if (strcmp(query, "deaths-near-walls") == 0 && argc >= 4) {
+        int distance = atoi(argv[3]);
+        long long limit = argc > 4 ? atoll(argv[4]) : 10;
+
+        uint64_t count = deathsNearWalls(log, distance, [&](uint64_t index, const AnalyticsRow& row) {
+            if (limit-- <= 0) return;
+            printf("  row %llu: tick %lld head (%lld, %lld) length %lld score %lld\n", (unsigned long long)index,
+                (long long)row[COLUMN_TICK], (long long)row[COLUMN_HEAD_X], (long long)row[COLUMN_HEAD_Y],
+                (long long)row[COLUMN_LENGTH], (long long)row[COLUMN_SCORE]);
+        });
+        printf("%llu games ended within %d cells of a wall\n", (unsigned long long)count, distance);
+    }
+    else {
+        return usage(argv[0]);
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    printf("(%.1f ms)\n", ms);
+    return 0;
+}
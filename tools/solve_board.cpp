@@ -0,0 +1,49 @@
+// Solves every position of a small board (common/solver.hpp) and writes the
+// table a SolverTable maps as a perfect-play oracle.
+//
+// usage: solve_board <width> <height> <walls|wrap> <table> [growth] [threads] [max positions]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <common/solver.hpp>
+
+int main(int argc, char** argv)
+{
+    if (argc < 5 || (strcmp(argv[3], "walls") != 0 && strcmp(argv[3], "wrap") != 0)) {
+        fprintf(stderr, "usage: %s <width> <height> <walls|wrap> <table> [growth] [threads] [max positions]\n", argv[0]);
+        return 2;
+    }
+    GameConfig config;
+    config.width = atoi(argv[1]);
+    config.height = atoi(argv[2]);
+    config.walls = strcmp(argv[3], "walls") == 0;
+    config.growth = argc > 5 ? atoi(argv[5]) : 1;
+    const int threads = argc > 6 ? atoi(argv[6]) : 0;
+    const uint64_t maxStates = argc > 7 ? strtoull(argv[7], nullptr, 10) : 50000000;
+    if (config.width < 2 || config.height < 2 || config.width * config.height > SolverPosition::MAX_CELLS || config.growth < 1) {
+        fprintf(stderr, "boards from 2x2 up to %d cells, growth 1 or more\n", SolverPosition::MAX_CELLS);
+        return 2;
+    }
+
+    SmallBoardSolver solver(config, threads, maxStates);
+    bool solved = solver.solve();
+    const SolverStats& stats = solver.getStats();
+    if (!solved) {
+        fprintf(stderr, "more than %llu positions after %.1f s (peak %.1f MB), not solved\n", (unsigned long long)maxStates,
+            stats.enumerateSeconds, stats.peakBytes / (1024.0 * 1024.0));
+        return 1;
+    }
+    SolverValue start = solver.startValue();
+    printf("%dx%d %s, growth %d: %llu positions in %d layers, peak %.1f MB, enumerated in %.2f s, solved in %.2f s\n",
+        config.width, config.height, argv[3], config.growth, (unsigned long long)stats.states, stats.layers,
+        stats.peakBytes / (1024.0 * 1024.0), stats.enumerateSeconds, stats.solveSeconds);
+    printf("perfect play is sure to score %d%s\n", solverScore(start), solverWin(start) ? " and cover the board" : "");
+
+    if (!solver.writeTable(argv[4])) {
+        fprintf(stderr, "could not write %s\n", argv[4]);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,172 @@
+// Re-simulates every replay in a directory and flags those whose final score
+// or state hash differs from what the file claims. Replays are spread over
+// worker threads that steal from each other once their own share runs out,
+// so a few very long games do not leave the other cores idle.
+//
+// usage: verify_replays <directory> [threads]
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <common/replay.hpp>
+
+// Helpers
+// ----------------------------------------------------------
+struct Verdict
+{
+    const char* problem;    // nullptr if the replay checks out
+    bool simulated;         // The replay was played back
+    uint64_t ticks;
+    int claimedScore, score;
+};
+
+static Verdict verify(const std::string& path)
+{
+    Verdict verdict{ nullptr, false, 0, 0, 0 };
+    ReplayFile replay;
+    // open() also turns down other rules versions and boards over the size limit
+    if (!replay.open(path.c_str())) {
+        verdict.problem = "not a replay, or recorded with other rules";
+        return verdict;
+    }
+
+    const ReplayHeader& header = replay.getHeader();
+    verdict.claimedScore = header.finalScore;
+    if (!replay.isFinished()) {
+        verdict.problem = "unfinished";
+        return verdict;
+    }
+
+    // The board passed open()'s limit but may still not fit in this machine's memory
+    ReplayOutcome outcome;
+    try {
+        outcome = playReplay(replay);
+    }
+    catch (const std::exception&) {
+        verdict.problem = "not a replay";
+        return verdict;
+    }
+    verdict.simulated = true;
+    verdict.ticks = outcome.ticks;
+    verdict.score = outcome.score;
+    if (outcome.score != header.finalScore) verdict.problem = "score mismatch";
+    else if (outcome.hash != header.finalHash) verdict.problem = "hash mismatch";
+    return verdict;
+}
+// ----------------------------------------------------------
+
+// Class definition
+// ----------------------------------------------------------
+// Per-worker task deque: the owner takes from the back, thieves from the front
+class TaskDeque
+{
+private:
+    std::mutex mutex;
+    std::deque<int> tasks;
+
+public:
+    void push(int task)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(task);
+    }
+    bool pop(int& task)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty()) return false;
+        task = tasks.back();
+        tasks.pop_back();
+        return true;
+    }
+    bool steal(int& task)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty()) return false;
+        task = tasks.front();
+        tasks.pop_front();
+        return true;
+    }
+};
+// ----------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <directory> [threads]\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<std::string> paths;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(argv[1], error)) {
+        if (entry.is_regular_file()) paths.push_back(entry.path().string());
+    }
+    if (error) {
+        fprintf(stderr, "can not read %s: %s\n", argv[1], error.message().c_str());
+        return 2;
+    }
+    std::sort(paths.begin(), paths.end());
+
+    int numThreads = argc > 2 ? atoi(argv[2]) : 0;
+    if (numThreads <= 0) numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    numThreads = std::max(1, std::min(numThreads, (int)paths.size()));
+
+    // Deal the replays round-robin, stealing evens out the rest
+    std::vector<TaskDeque> deques(numThreads);
+    for (int i = 0; i < (int)paths.size(); i++) deques[i % numThreads].push(i);
+
+    std::vector<Verdict> verdicts(paths.size());
+    std::atomic<uint64_t> totalTicks{ 0 };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int w = 0; w < numThreads; w++) {
+        workers.emplace_back([&, w]() {
+            uint64_t ticks = 0;
+            for (;;) {
+                int task;
+                bool found = deques[w].pop(task);
+                for (int v = 1; !found && v < numThreads; v++) {
+                    found = deques[(w + v) % numThreads].steal(task);
+                }
+                // Nothing is ever added once the workers run, empty everywhere means done
+                if (!found) break;
+
+                verdicts[task] = verify(paths[task]);
+                ticks += verdicts[task].ticks;
+            }
+            totalTicks += ticks;
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int flagged = 0;
+    for (size_t i = 0; i < paths.size(); i++) {
+        const Verdict& verdict = verdicts[i];
+        if (!verdict.problem) continue;
+        flagged++;
+        if (verdict.simulated) {
+            printf("FLAGGED %s: %s (claimed score %d, replayed %d)\n", paths[i].c_str(), verdict.problem,
+                verdict.claimedScore, verdict.score);
+        }
+        else {
+            printf("FLAGGED %s: %s\n", paths[i].c_str(), verdict.problem);
+        }
+    }
+
+    printf("%zu replays, %d flagged, %.3f s on %d threads\n", paths.size(), flagged, seconds, numThreads);
+    printf("%.0f replays/s, %.3g ticks/s\n", paths.size() / seconds, totalTicks.load() / seconds);
+    return flagged ? 1 : 0;
+}